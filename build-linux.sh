@@ -17,7 +17,9 @@ build_and_test() {
         -G "Ninja" \
         -D CMAKE_BUILD_TYPE="$build_type"
   cmake --build "$buildDir/${target}-$build_type"
-  "$buildDir/${target}-$build_type/arduino_dsmr_test"
+  for test in arduino_dsmr_test arduino_dsmr_test_fixed_string_fields arduino_dsmr_test_string_view_fields arduino_dsmr_test_typed_timestamps; do
+    "$buildDir/${target}-$build_type/$test"
+  done
 }
 
 build_and_test Debug linux-gcc
@@ -30,9 +30,11 @@ Function BuildAndTest($buildType, $arch) {
   cmake --build $thisBuildDir
   CheckReturnCodeOfPreviousCommand "cmake build failed"
 
-  Info "Run tests"
-  & "$thisBuildDir/arduino_dsmr_test.exe"
-  CheckReturnCodeOfPreviousCommand "tests failed"
+  foreach ($test in "arduino_dsmr_test", "arduino_dsmr_test_fixed_string_fields", "arduino_dsmr_test_string_view_fields", "arduino_dsmr_test_typed_timestamps") {
+    Info "Run $test"
+    & "$thisBuildDir/$test.exe"
+    CheckReturnCodeOfPreviousCommand "$test failed"
+  }
 }
 
 Set-StrictMode -Version Latest
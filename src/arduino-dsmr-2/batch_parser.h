@@ -0,0 +1,133 @@
+#pragma once
+
+#include "parser.h"
+#include "util.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace arduino_dsmr_2 {
+
+// Parses batches of complete telegrams on several threads, for example to backfill a database from an archive of millions of raw telegrams.
+// The result is the same as with P1Parser::parse_batch: telegrams[i] is parsed into outputs[i] and its result is stored in results[i].
+//
+// The threads are started once and reused for every batch. The calling thread takes part in the work, so with number_of_threads = 1
+// no threads are started. The telegrams are handed out in slices of slice_size telegrams through an atomic counter: a thread that got
+// short telegrams takes the next slice instead of waiting for the others. Every slice is parsed with P1Parser::parse_batch.
+// The parser keeps its state on the stack, so the threads only share the counter, and every thread writes to its own slices of the outputs.
+//
+// Note: with DSMR_STRING_VIEW_FIELDS, the outputs point into the telegrams, so the telegrams must outlive them.
+template <typename Data>
+class BatchParser : NonCopyableAndNonMovable {
+public:
+  struct Config {
+    std::size_t number_of_threads = 1; // including the thread that calls parse
+    std::size_t slice_size = 64;
+    bool unknown_error = false;
+    bool check_crc = true;
+  };
+
+private:
+  Config _config;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;
+  std::condition_variable _batch_started;
+  std::condition_variable _batch_finished;
+  uint64_t _batch_number = 0;
+  std::size_t _busy_threads = 0;
+  bool _closed = false;
+
+  // The current batch. It is written under the mutex before the threads are woken up.
+  std::span<const std::string_view> _telegrams;
+  std::span<Data> _outputs;
+  std::span<ParseResult<void>> _results;
+  std::atomic<std::size_t> _next_telegram{0};
+  std::atomic<std::size_t> _parsed{0};
+
+public:
+  explicit BatchParser(const Config& config) : _config(config) {
+    _config.number_of_threads = std::max<std::size_t>(_config.number_of_threads, 1);
+    _config.slice_size = std::max<std::size_t>(_config.slice_size, 1);
+    for (std::size_t i = 1; i < _config.number_of_threads; ++i)
+      _threads.emplace_back([this] { run(); });
+  }
+
+  ~BatchParser() {
+    {
+      std::lock_guard lock(_mutex);
+      _closed = true;
+    }
+    _batch_started.notify_all();
+    for (auto& thread : _threads)
+      thread.join();
+  }
+
+  // Blocks until the whole batch is parsed. Returns the number of telegrams without errors.
+  // Only as many telegrams are parsed as there are outputs and results. Must not be called from several threads at once.
+  std::size_t parse(std::span<const std::string_view> telegrams, std::span<Data> outputs, std::span<ParseResult<void>> results) {
+    const auto count = std::min({telegrams.size(), outputs.size(), results.size()});
+    {
+      std::lock_guard lock(_mutex);
+      _telegrams = telegrams.first(count);
+      _outputs = outputs.first(count);
+      _results = results.first(count);
+      _next_telegram.store(0, std::memory_order_relaxed);
+      _parsed.store(0, std::memory_order_relaxed);
+      _busy_threads = _threads.size();
+      ++_batch_number;
+    }
+    _batch_started.notify_all();
+
+    work();
+
+    std::unique_lock lock(_mutex);
+    _batch_finished.wait(lock, [&] { return _busy_threads == 0; });
+    return _parsed.load(std::memory_order_relaxed);
+  }
+
+private:
+  void run() {
+    uint64_t batch_number = 0;
+    while (true) {
+      {
+        std::unique_lock lock(_mutex);
+        _batch_started.wait(lock, [&] { return _closed || _batch_number != batch_number; });
+        if (_closed)
+          return;
+        batch_number = _batch_number;
+      }
+
+      work();
+
+      {
+        std::lock_guard lock(_mutex);
+        --_busy_threads;
+      }
+      _batch_finished.notify_one();
+    }
+  }
+
+  void work() {
+    const auto slice_size = _config.slice_size;
+    std::size_t parsed = 0;
+    while (true) {
+      const auto begin = _next_telegram.fetch_add(slice_size, std::memory_order_relaxed);
+      if (begin >= _telegrams.size())
+        break;
+      const auto size = std::min(slice_size, _telegrams.size() - begin);
+      parsed += P1Parser::parse_batch(_telegrams.subspan(begin, size), _outputs.subspan(begin, size), _results.subspan(begin, size), _config.unknown_error,
+                                      _config.check_crc);
+    }
+    _parsed.fetch_add(parsed, std::memory_order_relaxed);
+  }
+};
+
+}
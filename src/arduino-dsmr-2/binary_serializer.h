@@ -0,0 +1,333 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace arduino_dsmr_2 {
+
+// A compact binary encoding of ParsedData, for example to write telegrams to a ring log in the flash of an ESP32
+// or to pass them to another process through shared memory. The format of a record:
+//   - format version (1 byte)
+//   - schema id (4 bytes, little-endian): a hash of the names, OBIS ids and timestamp types of the fields, so a record is never decoded into another ParsedData
+//   - flags (1 byte): bit 0 is set if the record is encoded relative to a reference
+//   - presence bitmap: bit i of byte i / 8 is set if the field Ts[i] is present
+//   - the values of the present fields in the order of Ts:
+//     - numbers (FixedValue and IntField values) as LEB128 varints. With a reference, the difference with the value of the reference
+//       is encoded instead (zigzag, modulo 2^32), so slowly changing energy counters take a single byte.
+//     - strings as a varint length followed by the bytes. With a reference, the length is incremented by 1, and 0 means "the same as the reference".
+//     - TimestampedFixedValue as its timestamp followed by its number.
+//     - Timestamp (DSMR_TYPED_TIMESTAMPS) as its seconds, a number, followed by a byte with the summer time flag.
+//   A field that is not present in the reference is encoded as without a reference.
+//
+// A record encoded with a reference can only be decoded with the same reference, for example the previous record of the log.
+// Decoded std::string_view fields point into the record.
+struct BinarySerializer {
+  static constexpr uint8_t format_version = 1;
+
+  template <typename... Ts>
+  static constexpr uint32_t schema_id() {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const auto add = [&](const uint8_t byte) { hash = (hash ^ byte) * 16777619u; };
+    (
+        [&] {
+          for (const char c : std::string_view(Ts::name))
+            add(static_cast<uint8_t>(c));
+          for (const auto part : Ts::id.v)
+            add(part);
+          // A typed timestamp is encoded differently from its string
+          if constexpr (std::is_same_v<typename Ts::value_type, Timestamp> || std::is_same_v<typename Ts::value_type, TypedTimestampedFixedValue>)
+            add('T');
+        }(),
+        ...);
+    return hash;
+  }
+
+  // Encodes the present fields of data into out. Returns the size of the record, or 0 if it doesn't fit into out.
+  template <typename... Ts>
+  static size_t encode(const ParsedData<Ts...>& data, std::span<char> out, const ParsedData<Ts...>* reference = nullptr) {
+    Writer writer(out);
+    writer.byte(format_version);
+    constexpr auto schema = schema_id<Ts...>();
+    for (size_t i = 0; i < 4; ++i)
+      writer.byte(static_cast<uint8_t>(schema >> (i * 8)));
+    writer.byte(reference ? 1 : 0);
+
+    std::array<uint8_t, (sizeof...(Ts) + 7) / 8> presence{};
+    size_t index = 0;
+    (
+        [&] {
+          if (static_cast<const Ts&>(data).present())
+            presence[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+          ++index;
+        }(),
+        ...);
+    for (const auto byte : presence)
+      writer.byte(byte);
+
+    (encode_field<Ts>(writer, data, reference), ...);
+    return writer.overflow() ? 0 : writer.size();
+  }
+
+  // Decodes a record into data. The fields that are not in the record are marked as not present. The .next pointer of the result points after the record.
+  template <typename... Ts>
+  static ParseResult<void> decode(ParsedData<Ts...>* data, std::span<const char> in, const ParsedData<Ts...>* reference = nullptr) {
+    Reader reader(in);
+    if (reader.byte() != format_version)
+      return ParseResult<void>().fail("Unsupported format version", in.data());
+
+    uint32_t schema = 0;
+    for (size_t i = 0; i < 4; ++i)
+      schema |= uint32_t{reader.byte()} << (i * 8);
+    constexpr auto expected_schema = schema_id<Ts...>();
+    if (schema != expected_schema)
+      return ParseResult<void>().fail("Schema mismatch", in.data());
+
+    const bool delta = reader.byte() & 1;
+    if (delta && !reference)
+      return ParseResult<void>().fail("Reference required", in.data());
+
+    std::array<uint8_t, (sizeof...(Ts) + 7) / 8> presence{};
+    for (auto& byte : presence)
+      byte = reader.byte();
+    if (reader.error())
+      return ParseResult<void>().fail(reader.error(), reader.position());
+
+    size_t index = 0;
+    (
+        [&] {
+          static_cast<Ts&>(*data).present() = (presence[index / 8] >> (index % 8)) & 1;
+          ++index;
+        }(),
+        ...);
+
+    ((static_cast<Ts&>(*data).present() ? decode_field<Ts>(reader, *data, delta ? reference : nullptr) : void()), ...);
+    if (reader.error())
+      return ParseResult<void>().fail(reader.error(), reader.position());
+    return ParseResult<void>().until(reader.position());
+  }
+
+private:
+  class Writer {
+    char* _begin;
+    char* _pos;
+    char* _end;
+    bool _overflow = false;
+
+  public:
+    explicit Writer(std::span<char> out) : _begin(out.data()), _pos(out.data()), _end(out.data() + out.size()) {}
+
+    bool overflow() const { return _overflow; }
+    size_t size() const { return static_cast<size_t>(_pos - _begin); }
+
+    void byte(const uint8_t value) {
+      if (_pos == _end) {
+        _overflow = true;
+        return;
+      }
+      *_pos++ = static_cast<char>(value);
+    }
+
+    void varint(uint32_t value) {
+      while (value >= 0x80) {
+        byte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+      }
+      byte(static_cast<uint8_t>(value));
+    }
+
+    void bytes(const std::string_view value) {
+      if (value.size() > static_cast<size_t>(_end - _pos)) {
+        _overflow = true;
+        return;
+      }
+      std::memcpy(_pos, value.data(), value.size());
+      _pos += value.size();
+    }
+  };
+
+  class Reader {
+    const char* _pos;
+    const char* _end;
+    const char* _error = nullptr;
+
+  public:
+    explicit Reader(std::span<const char> in) : _pos(in.data()), _end(in.data() + in.size()) {}
+
+    const char* error() const { return _error; }
+    const char* position() const { return _pos; }
+
+    void fail(const char* error) {
+      if (!_error)
+        _error = error;
+    }
+
+    uint8_t byte() {
+      if (_pos == _end) {
+        fail("Truncated record");
+        return 0;
+      }
+      return static_cast<uint8_t>(*_pos++);
+    }
+
+    uint32_t varint() {
+      uint32_t value = 0;
+      for (unsigned shift = 0; shift < 35; shift += 7) {
+        const uint8_t b = byte();
+        value |= uint32_t{b & 0x7Fu} << shift;
+        if (!(b & 0x80))
+          return value;
+      }
+      fail("Invalid varint");
+      return 0;
+    }
+
+    std::string_view bytes(const size_t size) {
+      if (size > static_cast<size_t>(_end - _pos)) {
+        fail("Truncated record");
+        return {};
+      }
+      const auto result = std::string_view(_pos, size);
+      _pos += size;
+      return result;
+    }
+  };
+
+  static uint32_t zigzag(const uint32_t value, const uint32_t reference) {
+    const uint32_t diff = value - reference;
+    return (diff << 1) ^ (0u - (diff >> 31));
+  }
+  static uint32_t unzigzag(const uint32_t value, const uint32_t reference) { return reference + ((value >> 1) ^ (0u - (value & 1))); }
+
+  template <typename T>
+  static uint32_t to_uint32(const T value) {
+    if constexpr (std::is_same_v<T, uint32_t>)
+      return value;
+    else
+      return static_cast<uint32_t>(value);
+  }
+  template <typename T>
+  static T from_uint32(const uint32_t value) {
+    if constexpr (std::is_same_v<T, uint32_t>)
+      return value;
+    else
+      return static_cast<T>(value);
+  }
+
+  static void encode_number(Writer& writer, const uint32_t value, const uint32_t* reference) { writer.varint(reference ? zigzag(value, *reference) : value); }
+  static uint32_t decode_number(Reader& reader, const uint32_t* reference) {
+    const auto value = reader.varint();
+    return reference ? unzigzag(value, *reference) : value;
+  }
+
+  static void encode_string(Writer& writer, const std::string_view value, const std::string_view* reference) {
+    if (!reference) {
+      writer.varint(static_cast<uint32_t>(value.size()));
+    } else if (value == *reference) {
+      writer.varint(0);
+      return;
+    } else {
+      writer.varint(static_cast<uint32_t>(value.size() + 1));
+    }
+    writer.bytes(value);
+  }
+
+  template <typename String>
+  static void decode_string(Reader& reader, String& dst, const std::string_view* reference) {
+    auto size = reader.varint();
+    if (reference && size == 0) {
+      assign_string(dst, *reference);
+      return;
+    }
+    if (reference)
+      --size;
+
+    const auto value = reader.bytes(size);
+    if (value.size() > dst.max_size())
+      return reader.fail("Invalid string length");
+    assign_string(dst, value);
+  }
+
+  template <typename String>
+  static void encode_timestamp(Writer& writer, const String& value, const String* reference) {
+    const auto reference_value = reference ? std::string_view(*reference) : std::string_view();
+    encode_string(writer, value, reference ? &reference_value : nullptr);
+  }
+  static void encode_timestamp(Writer& writer, const Timestamp& value, const Timestamp* reference) {
+    encode_number(writer, value.seconds, reference ? &reference->seconds : nullptr);
+    writer.byte(value.summer_time);
+  }
+
+  template <typename String>
+  static void decode_timestamp(Reader& reader, String& value, const String* reference) {
+    const auto reference_value = reference ? std::string_view(*reference) : std::string_view();
+    decode_string(reader, value, reference ? &reference_value : nullptr);
+  }
+  static void decode_timestamp(Reader& reader, Timestamp& value, const Timestamp* reference) {
+    value.seconds = decode_number(reader, reference ? &reference->seconds : nullptr);
+    value.summer_time = reader.byte() & 1;
+  }
+
+  template <typename Field, typename... Ts>
+  static void encode_field(Writer& writer, const ParsedData<Ts...>& data, const ParsedData<Ts...>* reference) {
+    const Field& field = data;
+    if (!field.present())
+      return;
+
+    const auto& value = field.val();
+    using Value = typename Field::value_type;
+    // The value of a field that is not present can be anything, for example the value of an older record
+    const Field* const reference_field = reference && static_cast<const Field&>(*reference).present() ? static_cast<const Field*>(reference) : nullptr;
+
+    if constexpr (std::is_same_v<Value, FixedValue> || is_timestamped_value<Value>::value) {
+      if constexpr (is_timestamped_value<Value>::value) {
+        encode_timestamp(writer, value.timestamp, reference_field ? &reference_field->val().timestamp : nullptr);
+      }
+      const uint32_t reference_value = reference_field ? reference_field->val()._value : 0;
+      encode_number(writer, value._value, reference_field ? &reference_value : nullptr);
+    } else if constexpr (std::is_integral_v<Value>) {
+      const uint32_t reference_value = reference_field ? to_uint32(reference_field->val()) : 0;
+      encode_number(writer, to_uint32(value), reference_field ? &reference_value : nullptr);
+    } else if constexpr (std::is_same_v<Value, Timestamp>) {
+      encode_timestamp(writer, value, reference_field ? &reference_field->val() : nullptr);
+    } else {
+      static_assert(is_string_value<Value>::value, "The value type of the field is not supported");
+      const auto reference_value = reference_field ? std::string_view(reference_field->val()) : std::string_view();
+      encode_string(writer, value, reference_field ? &reference_value : nullptr);
+    }
+  }
+
+  template <typename Field, typename... Ts>
+  static void decode_field(Reader& reader, ParsedData<Ts...>& data, const ParsedData<Ts...>* reference) {
+    Field& field = data;
+    auto& value = field.val();
+    using Value = typename Field::value_type;
+    const Field* const reference_field = reference && static_cast<const Field&>(*reference).present() ? static_cast<const Field*>(reference) : nullptr;
+
+    if constexpr (std::is_same_v<Value, FixedValue> || is_timestamped_value<Value>::value) {
+      if constexpr (is_timestamped_value<Value>::value) {
+        decode_timestamp(reader, value.timestamp, reference_field ? &reference_field->val().timestamp : nullptr);
+      }
+      const uint32_t reference_value = reference_field ? reference_field->val()._value : 0;
+      value._value = decode_number(reader, reference_field ? &reference_value : nullptr);
+    } else if constexpr (std::is_integral_v<Value>) {
+      const uint32_t reference_value = reference_field ? to_uint32(reference_field->val()) : 0;
+      value = from_uint32<Value>(decode_number(reader, reference_field ? &reference_value : nullptr));
+    } else if constexpr (std::is_same_v<Value, Timestamp>) {
+      decode_timestamp(reader, value, reference_field ? &reference_field->val() : nullptr);
+    } else {
+      const auto reference_value = reference_field ? std::string_view(reference_field->val()) : std::string_view();
+      decode_string(reader, value, reference_field ? &reference_value : nullptr);
+    }
+  }
+};
+
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace arduino_dsmr_2 {
+
+// One bit for every row of a column. The bits after the last row are always 0.
+class PresenceBitmap {
+  std::vector<uint64_t> _words;
+
+public:
+  bool test(const size_t row) const { return (_words[row / 64] >> (row % 64)) & 1; }
+  void set(const size_t row) { _words[row / 64] |= uint64_t{1} << (row % 64); }
+
+  // Bit `row % 64` of word `row / 64` is the bit of the row
+  std::span<const uint64_t> words() const { return _words; }
+
+  void resize(const size_t rows) {
+    _words.resize((rows + 63) / 64);
+    if (rows % 64)
+      _words.back() &= (uint64_t{1} << (rows % 64)) - 1;
+  }
+};
+
+template <typename... Ts>
+class ColumnarData;
+
+// A column of numbers: FixedValue fields are stored as their integer value (int_val()), IntField fields as their own type.
+// The value of a row without the field is 0.
+template <typename T>
+class NumericColumn {
+  template <typename...>
+  friend class ColumnarData;
+
+  std::vector<T> _values;
+  PresenceBitmap _presence;
+
+  void resize(const size_t rows) {
+    _values.resize(rows);
+    _presence.resize(rows);
+  }
+  void set(const size_t row, const FixedValue& value) { _values[row] = value.int_val(); }
+  void set(const size_t row, const T value) { _values[row] = value; }
+
+public:
+  std::span<const T> values() const { return _values; }
+  const PresenceBitmap& presence() const { return _presence; }
+  bool present(const size_t row) const { return _presence.test(row); }
+  T operator[](const size_t row) const { return _values[row]; }
+};
+
+// A column of strings. Every distinct string is stored once in the dictionary, and a row stores the index of its string.
+// Meters repeat their equipment id and identification in every telegram, so the column takes 4 bytes per row.
+// The strings are copied, so the column doesn't point into the parsed telegrams even with DSMR_STRING_VIEW_FIELDS.
+// The hash table is keyed by views of the dictionary strings, which keep their addresses in a deque. A copy would point into the original column.
+class DictionaryColumn : NonCopyable {
+  template <typename...>
+  friend class ColumnarData;
+
+  std::vector<uint32_t> _codes;
+  PresenceBitmap _presence;
+  std::deque<std::string> _dictionary;
+  std::unordered_map<std::string_view, uint32_t> _lookup;
+  uint32_t _last_code = 0;
+
+  void resize(const size_t rows) {
+    _codes.resize(rows);
+    _presence.resize(rows);
+  }
+
+  void set(const size_t row, const std::string_view value) {
+    // Consecutive telegrams usually come from the same meter, so the string of the previous row is checked before the hash table
+    if (_last_code < _dictionary.size() && _dictionary[_last_code] == value) {
+      _codes[row] = _last_code;
+      return;
+    }
+
+    auto it = _lookup.find(value);
+    if (it == _lookup.end()) {
+      const auto code = static_cast<uint32_t>(_dictionary.size());
+      it = _lookup.emplace(_dictionary.emplace_back(value), code).first;
+    }
+    _last_code = it->second;
+    _codes[row] = it->second;
+  }
+
+public:
+  // Indexes into the dictionary. The code of a row without the field is 0.
+  std::span<const uint32_t> codes() const { return _codes; }
+  const std::deque<std::string>& dictionary() const { return _dictionary; }
+  const PresenceBitmap& presence() const { return _presence; }
+  bool present(const size_t row) const { return _presence.test(row); }
+  std::string_view operator[](const size_t row) const { return present(row) ? std::string_view(_dictionary[_codes[row]]) : std::string_view(); }
+};
+
+// A column of the values that are neither numbers nor strings, like TimestampedFixedValue. The values are stored as is.
+template <typename T>
+class ValueColumn {
+  template <typename...>
+  friend class ColumnarData;
+
+  std::vector<T> _values;
+  PresenceBitmap _presence;
+
+  void resize(const size_t rows) {
+    _values.resize(rows);
+    _presence.resize(rows);
+  }
+  void set(const size_t row, const T& value) { _values[row] = value; }
+
+public:
+  std::span<const T> values() const { return _values; }
+  const PresenceBitmap& presence() const { return _presence; }
+  bool present(const size_t row) const { return _presence.test(row); }
+  const T& operator[](const size_t row) const { return _values[row]; }
+};
+
+// The column type that stores the values of a field
+template <typename Field>
+using column_t = std::conditional_t<
+    std::is_same_v<typename Field::value_type, FixedValue>, NumericColumn<uint32_t>,
+    std::conditional_t<std::is_integral_v<typename Field::value_type>, NumericColumn<typename Field::value_type>,
+                       std::conditional_t<is_string_value<typename Field::value_type>::value, DictionaryColumn, ValueColumn<typename Field::value_type>>>>;
+
+// The struct-of-arrays counterpart of ParsedData for bulk decoding, for example of millions of archived telegrams.
+// It is generated from the same field list: ColumnarData<identification, equipment_id, power_delivered> has a column for every field,
+// and a telegram is one row. P1Parser writes into a row directly:
+//   ColumnarData<identification, equipment_id, power_delivered> data(telegrams.size());
+//   for (size_t i = 0; i < telegrams.size(); ++i) {
+//     auto row = data.row(i);
+//     P1Parser::parse(&row, telegrams[i].data(), telegrams[i].size());
+//   }
+//   for (const auto power : data.column<power_delivered>().values()) { ... } // contiguous uint32_t values in W
+//
+// See column_t for the column of every kind of field. Every column has a presence bitmap.
+template <typename... Ts>
+class ColumnarData {
+  size_t _size = 0;
+  std::tuple<column_t<Ts>...> _columns;
+  // A field is parsed into its object here, then its value is stored in the column.
+  // The objects are reused, so their strings keep the capacity and parsing a string field doesn't allocate memory.
+  std::tuple<Ts...> _scratch;
+
+public:
+  // A row of the table. It has the same parse_line method as ParsedData, so P1Parser::parse can parse a telegram into it.
+  class Row {
+    ColumnarData* _data;
+    size_t _index;
+
+  public:
+    Row(ColumnarData& data, const size_t index) : _data(&data), _index(index) {}
+
+    size_t index() const { return _index; }
+
+    ParseResult<void> parse_line(const ObisId& obisId, const char* str, const char* end) {
+      // The same lookup as in ParsedData, so if several fields have the same id, the first one in Ts wins
+      const auto index = ParsedData<Ts...>::field_index(obisId);
+      if (index == sizeof...(Ts))
+        return ParseResult<void>().until(str);
+
+      return parse_field_at(*_data, index, _index, str, end);
+    }
+  };
+
+  explicit ColumnarData(const size_t size = 0) { resize(size); }
+
+  size_t size() const { return _size; }
+
+  // The new rows are empty. The dictionaries of the string columns are kept.
+  void resize(const size_t size) {
+    _size = size;
+    std::apply([&](auto&... columns) { (columns.resize(size), ...); }, _columns);
+  }
+
+  void clear() { resize(0); }
+
+  // Every field can be parsed into a row once, so a row must be empty (see resize) before a telegram is parsed into it.
+  // Rows of the same ColumnarData can't be parsed on several threads at once.
+  Row row(const size_t index) { return Row(*this, index); }
+
+  template <typename Field>
+  const column_t<Field>& column() const {
+    return std::get<index_of<Field>()>(_columns);
+  }
+
+private:
+  template <typename Field>
+  static constexpr size_t index_of() {
+    constexpr std::array<bool, sizeof...(Ts)> matches{std::is_same_v<Field, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      if (matches[i])
+        return i;
+    }
+    return sizeof...(Ts);
+  }
+
+  template <size_t I>
+  static ParseResult<void> parse_field(ColumnarData& data, const size_t row, const char* str, const char* end) {
+    using Field = std::tuple_element_t<I, std::tuple<Ts...>>;
+    auto& column = std::get<I>(data._columns);
+    if (column.present(row))
+      return ParseResult<void>().fail("Duplicate field", str);
+
+    column._presence.set(row);
+    [[maybe_unused]] const timing::FieldTimer<Field> timer;
+    auto& field = std::get<I>(data._scratch);
+    if constexpr (is_string_value<typename Field::value_type>::value)
+      assign_string(field.val(), std::string_view()); // RawField appends to the value
+    const auto res = field.parse(str, end);
+    if (!res.err)
+      column.set(row, field.val());
+    return res;
+  }
+
+  // Parses the value of the field with the index in Ts
+  static ParseResult<void> parse_field_at(ColumnarData& data, const size_t index, const size_t row, const char* str, const char* end) {
+    static constexpr auto parsers = make_field_parsers(std::index_sequence_for<Ts...>());
+    return parsers[index](data, row, str, end);
+  }
+
+  using FieldParser = ParseResult<void> (*)(ColumnarData&, size_t, const char*, const char*);
+
+  template <size_t... I>
+  static constexpr std::array<FieldParser, sizeof...(Ts)> make_field_parsers(std::index_sequence<I...>) {
+    return {&parse_field<I>...};
+  }
+};
+
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace arduino_dsmr_2 {
+
+enum class ConcentratorError { BufferOverflow, PacketStartSymbolInPacket, IncorrectCrcCharacter, NoFreeBuffer, ParseError };
+
+inline const char* to_string(const ConcentratorError error) {
+  switch (error) {
+  case ConcentratorError::BufferOverflow:
+    return "BufferOverflow";
+  case ConcentratorError::PacketStartSymbolInPacket:
+    return "PacketStartSymbolInPacket";
+  case ConcentratorError::IncorrectCrcCharacter:
+    return "IncorrectCrcCharacter";
+  case ConcentratorError::NoFreeBuffer:
+    return "NoFreeBuffer";
+  case ConcentratorError::ParseError:
+    return "ParseError";
+  }
+
+  // unreachable
+  return "Unknown error";
+}
+
+// Receives and parses telegrams from many P1 streams at once, for example on a Linux box that collects the data of thousands of meters.
+// Every stream has an id in [0, number_of_streams). Bytes are passed with push(stream_id, chunk) in the order they were received.
+//
+// The streams are split between worker threads (stream_id % number_of_workers), so the chunks of one stream are always processed
+// by the same worker in the order they were pushed. Every worker:
+//   - keeps the framing state of its streams in a struct-of-arrays layout (10 bytes per stream).
+//   - owns a pool of packet buffers in one allocation. A stream only holds a buffer between the packet start symbol and the end of the packet.
+//     By default, there is a buffer for every stream. With fewer buffers, a packet that starts when all buffers are in use is dropped (NoFreeBuffer).
+//   - parses every complete packet with P1Parser::parse into a new Data and puts the result into a queue that is shared by all workers.
+//
+// Both queues are bounded. push blocks while the worker of the stream has max_pending_bytes_per_worker bytes to process.
+// Workers block while the result queue is full. Results are taken with pop or try_pop.
+// A thread that both pushes and pops has to use try_push: push can wait for a worker that waits for the results to be taken.
+template <typename Data>
+class Concentrator : NonCopyableAndNonMovable {
+  static_assert(!has_string_view_fields<Data>::value, "The results are used after the packet buffer is reused, so Data can't contain std::string_view fields");
+
+public:
+  struct Config {
+    std::size_t number_of_streams = 1;
+    std::size_t number_of_workers = 1;
+    std::size_t buffer_size = 4096;     // the maximum size of a packet
+    std::size_t buffers_per_worker = 0; // 0 = a buffer for every stream of the worker
+    std::size_t result_queue_capacity = 1024;
+    std::size_t max_pending_bytes_per_worker = 64 * 1024;
+    bool check_crc = true;
+  };
+
+  struct Result {
+    std::size_t stream_id = 0;
+    std::optional<ConcentratorError> error;
+    const char* parse_error = nullptr; // the error message of P1Parser::parse when error is ParseError
+    Data data;                         // the parsed telegram when there is no error
+  };
+
+private:
+  class Worker {
+    enum class State : uint8_t { WaitingForPacketStartSymbol, WaitingForPacketEndSymbol, WaitingForCrc };
+    static constexpr uint32_t no_buffer = UINT32_MAX;
+
+    struct Chunk {
+      uint32_t stream;
+      uint32_t size;
+    };
+
+    Concentrator& _concentrator;
+    const std::size_t _index;
+
+    // Framing state of the streams, indexed by stream_id / number_of_workers
+    std::vector<State> _state;
+    std::vector<uint8_t> _crc_length;
+    std::vector<uint32_t> _buffer;
+    std::vector<uint32_t> _size;
+
+    // Packet buffer pool
+    std::vector<char> _pool;
+    std::vector<uint32_t> _free_buffers;
+
+    // Chunks pushed by the producers. The worker swaps them with its own vectors and processes them without holding the lock.
+    std::mutex _mutex;
+    std::condition_variable _chunks_available;
+    std::condition_variable _space_available;
+    std::vector<char> _pending_bytes;
+    std::vector<Chunk> _pending_chunks;
+    bool _closed = false;
+
+    std::thread _thread;
+
+  public:
+    Worker(Concentrator& concentrator, const std::size_t index, const std::size_t number_of_streams)
+        : _concentrator(concentrator), _index(index), _state(number_of_streams, State::WaitingForPacketStartSymbol), _crc_length(number_of_streams),
+          _buffer(number_of_streams, no_buffer), _size(number_of_streams) {
+      const auto& config = _concentrator._config;
+      const auto number_of_buffers = config.buffers_per_worker ? config.buffers_per_worker : number_of_streams;
+      _pool.resize(number_of_buffers * config.buffer_size);
+      for (std::size_t i = number_of_buffers; i > 0; --i)
+        _free_buffers.push_back(static_cast<uint32_t>(i - 1));
+      _thread = std::thread([this] { run(); });
+    }
+
+    bool push(const std::size_t stream, std::span<const char> bytes, const bool wait) {
+      {
+        std::unique_lock lock(_mutex);
+        const auto can_push = [&] {
+          return _closed || _pending_bytes.empty() || _pending_bytes.size() + bytes.size() <= _concentrator._config.max_pending_bytes_per_worker;
+        };
+        if (wait)
+          _space_available.wait(lock, can_push);
+        if (_closed || !can_push())
+          return false;
+
+        _pending_bytes.insert(_pending_bytes.end(), bytes.begin(), bytes.end());
+        _pending_chunks.push_back({static_cast<uint32_t>(stream), static_cast<uint32_t>(bytes.size())});
+      }
+      _chunks_available.notify_one();
+      return true;
+    }
+
+    void close() {
+      {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+      }
+      _chunks_available.notify_one();
+      _space_available.notify_all();
+    }
+
+    void join() {
+      if (_thread.joinable())
+        _thread.join();
+    }
+
+  private:
+    void run() {
+      std::vector<char> bytes;
+      std::vector<Chunk> chunks;
+
+      while (true) {
+        {
+          std::unique_lock lock(_mutex);
+          _chunks_available.wait(lock, [&] { return _closed || !_pending_chunks.empty(); });
+          if (_pending_chunks.empty())
+            break;
+          std::swap(bytes, _pending_bytes);
+          std::swap(chunks, _pending_chunks);
+        }
+        _space_available.notify_all();
+
+        const char* p = bytes.data();
+        for (const auto& chunk : chunks) {
+          process(chunk.stream, p, p + chunk.size);
+          p += chunk.size;
+        }
+        bytes.clear();
+        chunks.clear();
+      }
+
+      _concentrator.worker_finished();
+    }
+
+    std::size_t stream_id(const uint32_t stream) const { return stream * _concentrator._config.number_of_workers + _index; }
+    char* buffer(const uint32_t stream) { return _pool.data() + std::size_t{_buffer[stream]} * _concentrator._config.buffer_size; }
+
+    void release_buffer(const uint32_t stream) {
+      _free_buffers.push_back(_buffer[stream]);
+      _buffer[stream] = no_buffer;
+      _state[stream] = State::WaitingForPacketStartSymbol;
+    }
+
+    void fail(const uint32_t stream, const ConcentratorError error) {
+      Result res;
+      res.stream_id = stream_id(stream);
+      res.error = error;
+      _concentrator.deliver(std::move(res));
+    }
+
+    bool append(const uint32_t stream, const char* bytes, const std::size_t size) {
+      if (_size[stream] + size > _concentrator._config.buffer_size) {
+        release_buffer(stream);
+        fail(stream, ConcentratorError::BufferOverflow);
+        return false;
+      }
+      std::memcpy(buffer(stream) + _size[stream], bytes, size);
+      _size[stream] += static_cast<uint32_t>(size);
+      return true;
+    }
+
+    void start_packet(const uint32_t stream) {
+      _size[stream] = 0;
+      _state[stream] = State::WaitingForPacketEndSymbol;
+      append(stream, "/", 1);
+    }
+
+    void finish_packet(const uint32_t stream) {
+      Result res;
+      res.stream_id = stream_id(stream);
+      const auto& parse_result = P1Parser::parse(&res.data, buffer(stream), _size[stream], false, _concentrator._config.check_crc);
+      if (parse_result.err) {
+        res.error = ConcentratorError::ParseError;
+        res.parse_error = parse_result.err;
+      }
+      release_buffer(stream);
+      _concentrator.deliver(std::move(res));
+    }
+
+    // Same framing as PacketAccumulator: a packet starts with '/' and ends with '!' followed by 4 hex CRC symbols (when the CRC is checked).
+    // A '/' inside a packet starts the next packet. The CRC value itself is checked by P1Parser::parse.
+    void process(const uint32_t stream, const char* p, const char* const end) {
+      while (p < end) {
+        switch (_state[stream]) {
+        case State::WaitingForPacketStartSymbol:
+          p = find(p, end, '/');
+          if (p == end)
+            return;
+          ++p;
+          if (_free_buffers.empty()) {
+            fail(stream, ConcentratorError::NoFreeBuffer);
+            break;
+          }
+          _buffer[stream] = _free_buffers.back();
+          _free_buffers.pop_back();
+          start_packet(stream);
+          break;
+
+        case State::WaitingForPacketEndSymbol: {
+          const char* const stop = find(p, find(p, end, '!'), '/');
+          if (!append(stream, p, static_cast<std::size_t>(stop - p))) {
+            p = stop;
+            break;
+          }
+          p = stop;
+          if (p == end)
+            return;
+
+          if (*p++ == '/') {
+            fail(stream, ConcentratorError::PacketStartSymbolInPacket);
+            start_packet(stream);
+            break;
+          }
+
+          if (!append(stream, "!", 1))
+            break;
+          if (!_concentrator._config.check_crc) {
+            finish_packet(stream);
+            break;
+          }
+          _state[stream] = State::WaitingForCrc;
+          _crc_length[stream] = 0;
+          break;
+        }
+
+        case State::WaitingForCrc:
+          if (*p == '/') {
+            ++p;
+            fail(stream, ConcentratorError::PacketStartSymbolInPacket);
+            start_packet(stream);
+            break;
+          }
+          if (!is_crc_symbol(*p)) {
+            ++p;
+            release_buffer(stream);
+            fail(stream, ConcentratorError::IncorrectCrcCharacter);
+            break;
+          }
+          if (!append(stream, p++, 1))
+            break;
+          if (++_crc_length[stream] == 4)
+            finish_packet(stream);
+          break;
+        }
+      }
+    }
+
+    static bool is_crc_symbol(const char c) { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'); }
+
+    static const char* find(const char* begin, const char* end, const char byte) {
+      const auto found = std::memchr(begin, byte, static_cast<std::size_t>(end - begin));
+      return found ? static_cast<const char*>(found) : end;
+    }
+  };
+
+  Config _config;
+  std::vector<std::unique_ptr<Worker>> _workers;
+
+  std::mutex _results_mutex;
+  std::condition_variable _result_available;
+  std::condition_variable _result_space_available;
+  std::deque<Result> _results;
+  std::size_t _running_workers = 0;
+  bool _discard_results = false;
+
+  void deliver(Result&& res) {
+    {
+      std::unique_lock lock(_results_mutex);
+      _result_space_available.wait(lock, [&] { return _discard_results || _results.size() < _config.result_queue_capacity; });
+      if (_discard_results)
+        return;
+      _results.push_back(std::move(res));
+    }
+    _result_available.notify_one();
+  }
+
+  void worker_finished() {
+    {
+      std::lock_guard lock(_results_mutex);
+      --_running_workers;
+    }
+    _result_available.notify_all();
+  }
+
+public:
+  explicit Concentrator(const Config& config) : _config(config) {
+    _config.number_of_workers = std::max<std::size_t>(_config.number_of_workers, 1);
+    const auto number_of_workers = _config.number_of_workers;
+    _running_workers = number_of_workers;
+    for (std::size_t i = 0; i < number_of_workers; ++i) {
+      const auto streams_of_worker = (_config.number_of_streams + number_of_workers - 1 - i) / number_of_workers;
+      _workers.push_back(std::make_unique<Worker>(*this, i, streams_of_worker));
+    }
+  }
+
+  // Stops the workers. The results that were not taken yet are discarded.
+  ~Concentrator() {
+    {
+      std::lock_guard lock(_results_mutex);
+      _discard_results = true;
+    }
+    _result_space_available.notify_all();
+    close();
+    for (auto& worker : _workers)
+      worker->join();
+  }
+
+  // Passes bytes received from a stream. Returns false if the stream id is out of range or the concentrator is closed.
+  // Blocks while the worker of the stream is busy. The worker can wait for free space in the result queue,
+  // so the results have to be taken by another thread. Otherwise, use try_push.
+  bool push(const std::size_t stream_id, std::span<const char> bytes) { return push(stream_id, bytes, true); }
+
+  // Same as push, but doesn't block. Also returns false if the worker of the stream has too many bytes to process,
+  // in that case take the results with try_pop and push the bytes again.
+  bool try_push(const std::size_t stream_id, std::span<const char> bytes) { return push(stream_id, bytes, false); }
+
+  // No more bytes can be pushed. The bytes that were already pushed are still processed,
+  // after that pop returns an empty optional.
+  void close() {
+    for (auto& worker : _workers)
+      worker->close();
+  }
+
+  // Waits for the next result. Returns an empty optional when the concentrator is closed and all results were taken.
+  std::optional<Result> pop() {
+    std::unique_lock lock(_results_mutex);
+    _result_available.wait(lock, [&] { return !_results.empty() || _running_workers == 0; });
+    return take_result(lock);
+  }
+
+  // Returns the next result if there is one
+  std::optional<Result> try_pop() {
+    std::unique_lock lock(_results_mutex);
+    return take_result(lock);
+  }
+
+private:
+  bool push(const std::size_t stream_id, std::span<const char> bytes, const bool wait) {
+    if (stream_id >= _config.number_of_streams)
+      return false;
+    return _workers[stream_id % _config.number_of_workers]->push(stream_id / _config.number_of_workers, bytes, wait);
+  }
+
+  std::optional<Result> take_result(std::unique_lock<std::mutex>& lock) {
+    if (_results.empty())
+      return {};
+
+    std::optional<Result> res(std::move(_results.front()));
+    _results.pop_front();
+    lock.unlock();
+    _result_space_available.notify_one();
+    return res;
+  }
+};
+
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DSMR_CRC16_CLMUL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#define DSMR_CRC16_CLMUL_ARM 1
+#include <arm_neon.h>
+#endif
+
+namespace arduino_dsmr_2 {
+
+// DSMR telegrams are protected by CRC16/ARC: polynomial x^16+x^15+x^2+1 (0xA001 in the reflected form),
+// initial value 0, no final xor.
+// There are several implementations with different speed/memory trade-offs. All of them have the same interface:
+//   static uint16_t update(uint16_t crc, uint8_t byte);
+//   static uint16_t update(uint16_t crc, const char* data, size_t size);
+//
+// Crc16Bitwise    - no lookup tables, 8 iterations per byte.
+// Crc16Table      - one 256-entry table (512 bytes of flash), 1 lookup per byte.
+// Crc16SlicingBy4 - four tables (2 KB), processes 4 bytes per iteration.
+// Crc16SlicingBy8 - eight tables (4 KB), processes 8 bytes per iteration.
+// Crc16Clmul      - folds 16 bytes per iteration with carry-less multiplication (PCLMULQDQ on x86-64, PMULL on AArch64 with the crypto extension).
+//                   The fastest option on hosts. Falls back to Crc16SlicingBy8 on CPUs and targets without carry-less multiplication.
+//
+// The implementation used by the library is selected with the DSMR_CRC16_IMPLEMENTATION macro.
+// PacketAccumulator::process copies the packet body in runs of hundreds of bytes and updates the CRC of every run at once with
+// DSMR_CRC16_BULK_IMPLEMENTATION, so the carry-less multiplication and the 4 KB of slicing-by-8 tables pay off there.
+// Set it to Crc16Table to keep a single table.
+#ifndef DSMR_CRC16_IMPLEMENTATION
+#define DSMR_CRC16_IMPLEMENTATION Crc16Table
+#endif
+#ifndef DSMR_CRC16_BULK_IMPLEMENTATION
+#define DSMR_CRC16_BULK_IMPLEMENTATION Crc16Clmul
+#endif
+
+namespace crc16_detail {
+inline constexpr uint16_t polynomial = 0xA001;
+
+inline constexpr uint16_t update_bitwise(uint16_t crc, const uint8_t byte) {
+  crc ^= byte;
+  for (std::size_t i = 0; i < 8; ++i) {
+    if (crc & 1) {
+      crc = static_cast<uint16_t>((crc >> 1) ^ polynomial);
+    } else {
+      crc = static_cast<uint16_t>(crc >> 1);
+    }
+  }
+  return crc;
+}
+
+// tables[k][i] is the CRC of the byte i followed by k zero bytes
+template <std::size_t N>
+constexpr auto make_tables() {
+  std::array<std::array<uint16_t, 256>, N> tables{};
+  for (std::size_t i = 0; i < 256; ++i) {
+    tables[0][i] = update_bitwise(0, static_cast<uint8_t>(i));
+  }
+  for (std::size_t k = 1; k < N; ++k) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      const uint16_t prev = tables[k - 1][i];
+      tables[k][i] = static_cast<uint16_t>((prev >> 8) ^ tables[0][prev & 0xFF]);
+    }
+  }
+  return tables;
+}
+
+template <std::size_t N>
+inline constexpr auto tables = make_tables<N>();
+
+// The first table of every set is the same, so the slicing implementations use their own copy for single bytes
+template <std::size_t N>
+inline uint16_t update_table(const uint16_t crc, const uint8_t byte) {
+  return static_cast<uint16_t>((crc >> 8) ^ tables<N>[0][(crc ^ byte) & 0xFF]);
+}
+
+// Processes N bytes at once. The CRC is xor-ed into the first two bytes, after that every byte is looked up
+// in the table that corresponds to the number of bytes that follow it.
+template <std::size_t N>
+inline uint16_t update_slicing(uint16_t crc, const char* data, std::size_t size) {
+  const auto& t = tables<N>;
+  const auto* p = reinterpret_cast<const uint8_t*>(data);
+  const auto* const end = p + size;
+
+  while (end - p >= static_cast<std::ptrdiff_t>(N)) {
+    uint16_t next = static_cast<uint16_t>(t[N - 1][(p[0] ^ crc) & 0xFF] ^ t[N - 2][(p[1] ^ (crc >> 8)) & 0xFF]);
+    for (std::size_t i = 2; i < N; ++i) {
+      next ^= t[N - 1 - i][p[i]];
+    }
+    crc = next;
+    p += N;
+  }
+
+  while (p < end) {
+    crc = update_table<N>(crc, *p++);
+  }
+  return crc;
+}
+
+// Folding with carry-less multiplication, as in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+// The CRC of a message M is M * x^16 mod P. A 16-byte accumulator A holds a polynomial that is congruent to the message so far, and every
+// 16-byte block B folds into it: A' = A * x^128 + B = H * x^192 + L * x^128 + B, where H and L are the halves of A, and x^192 and x^128 are
+// replaced by their remainders mod P, so the products fit into 128 bits again. The CRC of the final accumulator is calculated with the tables.
+// The bytes are in the reflected bit order of CRC16/ARC: bit 0 of the first byte is the highest power of x. A carry-less product of two such
+// 64-bit operands is one bit short of the reflected 128-bit order, which is made up by using x^191 and x^127 instead.
+
+// x^n mod x^16+x^15+x^2+1, with bit i as the coefficient of x^i
+constexpr uint16_t x_pow_mod(const std::size_t n) {
+  uint32_t result = 1;
+  for (std::size_t i = 0; i < n; ++i) {
+    result <<= 1;
+    if (result & 0x10000)
+      result ^= 0x18005;
+  }
+  return static_cast<uint16_t>(result);
+}
+
+// x^n mod P as a reflected 64-bit operand: the coefficient of x^i is bit 63 - i
+constexpr uint64_t fold_constant(const std::size_t n) {
+  const auto remainder = x_pow_mod(n);
+  uint64_t result = 0;
+  for (std::size_t i = 0; i < 16; ++i) {
+    if ((remainder >> i) & 1)
+      result |= uint64_t{1} << (63 - i);
+  }
+  return result;
+}
+
+inline constexpr uint64_t fold_high = fold_constant(191);
+inline constexpr uint64_t fold_low = fold_constant(127);
+
+#if DSMR_CRC16_CLMUL_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DSMR_CRC16_CLMUL_TARGET
+inline bool cpu_has_clmul() {
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 1)) != 0;
+}
+#else
+#define DSMR_CRC16_CLMUL_TARGET __attribute__((target("pclmul,sse2")))
+inline bool cpu_has_clmul() { return __builtin_cpu_supports("pclmul"); }
+#endif
+
+// Requires size >= 16
+DSMR_CRC16_CLMUL_TARGET inline uint16_t update_clmul(const uint16_t crc, const char* data, const std::size_t size) {
+  const __m128i constants = _mm_set_epi64x(static_cast<long long>(fold_low), static_cast<long long>(fold_high));
+  const char* p = data;
+  const char* const end = data + size;
+
+  __m128i accumulator = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_cvtsi32_si128(crc));
+  for (p += 16; end - p >= 16; p += 16) {
+    const __m128i folded = _mm_xor_si128(_mm_clmulepi64_si128(accumulator, constants, 0x00), _mm_clmulepi64_si128(accumulator, constants, 0x11));
+    accumulator = _mm_xor_si128(folded, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+
+  char folded[16];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), accumulator);
+  return update_slicing<8>(update_slicing<8>(0, folded, sizeof(folded)), p, static_cast<std::size_t>(end - p));
+}
+#undef DSMR_CRC16_CLMUL_TARGET
+#elif DSMR_CRC16_CLMUL_ARM
+inline bool cpu_has_clmul() { return true; }
+
+// Requires size >= 16
+inline uint16_t update_clmul(const uint16_t crc, const char* data, const std::size_t size) {
+  const char* p = data;
+  const char* const end = data + size;
+
+  uint64x2_t accumulator = veorq_u64(vreinterpretq_u64_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p))), vsetq_lane_u64(crc, vdupq_n_u64(0), 0));
+  for (p += 16; end - p >= 16; p += 16) {
+    const auto high = vreinterpretq_u64_p128(vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(accumulator, 0)), static_cast<poly64_t>(fold_high)));
+    const auto low = vreinterpretq_u64_p128(vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(accumulator, 1)), static_cast<poly64_t>(fold_low)));
+    accumulator = veorq_u64(veorq_u64(high, low), vreinterpretq_u64_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p))));
+  }
+
+  char folded[16];
+  vst1q_u8(reinterpret_cast<uint8_t*>(folded), vreinterpretq_u8_u64(accumulator));
+  return update_slicing<8>(update_slicing<8>(0, folded, sizeof(folded)), p, static_cast<std::size_t>(end - p));
+}
+#else
+inline bool cpu_has_clmul() { return false; }
+inline uint16_t update_clmul(const uint16_t crc, const char* data, const std::size_t size) { return update_slicing<8>(crc, data, size); }
+#endif
+}
+
+struct Crc16Bitwise {
+  static uint16_t update(const uint16_t crc, const uint8_t byte) { return crc16_detail::update_bitwise(crc, byte); }
+
+  static uint16_t update(uint16_t crc, const char* data, const std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i)
+      crc = crc16_detail::update_bitwise(crc, static_cast<uint8_t>(data[i]));
+    return crc;
+  }
+};
+
+struct Crc16Table {
+  static uint16_t update(const uint16_t crc, const uint8_t byte) { return crc16_detail::update_table<1>(crc, byte); }
+
+  static uint16_t update(uint16_t crc, const char* data, const std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i)
+      crc = crc16_detail::update_table<1>(crc, static_cast<uint8_t>(data[i]));
+    return crc;
+  }
+};
+
+struct Crc16SlicingBy4 {
+  static uint16_t update(const uint16_t crc, const uint8_t byte) { return crc16_detail::update_table<4>(crc, byte); }
+  static uint16_t update(const uint16_t crc, const char* data, const std::size_t size) { return crc16_detail::update_slicing<4>(crc, data, size); }
+};
+
+struct Crc16SlicingBy8 {
+  static uint16_t update(const uint16_t crc, const uint8_t byte) { return crc16_detail::update_table<8>(crc, byte); }
+  static uint16_t update(const uint16_t crc, const char* data, const std::size_t size) { return crc16_detail::update_slicing<8>(crc, data, size); }
+};
+
+struct Crc16Clmul {
+  static uint16_t update(const uint16_t crc, const uint8_t byte) { return crc16_detail::update_table<8>(crc, byte); }
+
+  static uint16_t update(const uint16_t crc, const char* data, const std::size_t size) {
+    static const bool has_clmul = crc16_detail::cpu_has_clmul();
+    // The tables are faster for the few bytes of a short run
+    if (size >= 32 && has_clmul)
+      return crc16_detail::update_clmul(crc, data, size);
+    return crc16_detail::update_slicing<8>(crc, data, size);
+  }
+};
+
+using Crc16 = DSMR_CRC16_IMPLEMENTATION;
+using Crc16Bulk = DSMR_CRC16_BULK_IMPLEMENTATION;
+
+// uses polynomial x^16+x^15+x^2+1
+inline uint16_t crc16_update(const uint16_t crc, const uint8_t data) { return Crc16::update(crc, data); }
+
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arduino_dsmr_2 {
+
+template <typename Data>
+class DeltaParser;
+
+// Parses a stream of telegrams from one meter and only parses the lines that changed since the previous telegram.
+// Most values (energy counters, equipment id, p1 version, M-Bus ids) change rarely, but a DSMR 5 meter sends a telegram every second.
+//
+// The parser keeps a copy of the previous telegram. The value of every line is compared byte by byte with the value of the same field
+// in the previous telegram. If the bytes are identical, the field keeps its value and the line isn't parsed.
+// changed_fields() tells which fields were parsed again, appeared or disappeared, so a publisher (MQTT, database) can only send the deltas:
+//   DeltaParser<ParsedData<identification, energy_delivered_tariff1, power_delivered>> parser;
+//   if (!parser.parse(packet.data(), packet.size()).err)
+//     parser.apply_changed(publisher); // calls publisher.apply(field) for every changed field; a field that disappeared is not present()
+//
+// After an error, data() is empty and the next telegram is parsed completely. The CRC is checked on every telegram.
+template <typename... Ts>
+class DeltaParser<ParsedData<Ts...>> {
+  using Data = ParsedData<Ts...>;
+  static_assert(!has_string_view_fields<Data>::value, "The fields keep their values between telegrams, so Data can't contain std::string_view fields");
+  static constexpr size_t number_of_fields = sizeof...(Ts);
+
+  struct Value {
+    uint32_t offset = 0; // in _telegram
+    uint32_t size = 0;
+  };
+
+  Data _data;
+  std::bitset<number_of_fields> _changed;
+
+  // The previous telegram and the position of the value of every field in it
+  std::vector<char> _telegram;
+  std::array<Value, number_of_fields> _values{};
+
+  // The state of the telegram that is being parsed
+  const char* _current_telegram = nullptr;
+  std::array<Value, number_of_fields> _current_values{};
+  std::bitset<number_of_fields> _seen;
+
+  // Receives the lines from P1Parser::parse
+  class Lines {
+    DeltaParser& _parser;
+
+  public:
+    explicit Lines(DeltaParser& parser) : _parser(parser) {}
+    ParseResult<void> parse_line(const ObisId& obisId, const char* str, const char* end) { return _parser.parse_line(obisId, str, end); }
+  };
+
+public:
+  // Parses a complete telegram, the same way as P1Parser::parse
+  ParseResult<void> parse(const char* str, const size_t n, const bool unknown_error = false, const bool check_crc = true) {
+    _changed.reset();
+    _seen.reset();
+    _current_telegram = str;
+
+    Lines lines(*this);
+    const auto res = P1Parser::parse(&lines, str, n, unknown_error, check_crc);
+    if (res.err) {
+      reset();
+      return res;
+    }
+
+    // The fields that are not in this telegram anymore
+    reset_fields(~_seen & present_fields(std::index_sequence_for<Ts...>()));
+
+    _telegram.assign(str, str + n);
+    _values = _current_values;
+    return res;
+  }
+
+  // The fields of the last telegram
+  const Data& data() const { return _data; }
+
+  // Bit i is set if the field Ts[i] was parsed from the last telegram, or was removed because the last telegram didn't contain it
+  const std::bitset<number_of_fields>& changed_fields() const { return _changed; }
+
+  template <typename Field>
+  bool changed() const {
+    return _changed[index_of<Field>()];
+  }
+
+  // Calls f.apply(field) for every changed field, like ParsedData::applyEach
+  template <typename F>
+  void apply_changed(F&& f) {
+    apply_changed(f, std::index_sequence_for<Ts...>());
+  }
+
+  // Forgets the previous telegram, so the next telegram is parsed completely
+  void reset() {
+    _data = Data();
+    _telegram.clear();
+    _values = {};
+  }
+
+private:
+  ParseResult<void> parse_line(const ObisId& obisId, const char* str, const char* end) {
+    const auto index = Data::field_index(obisId);
+    if (index == number_of_fields)
+      return ParseResult<void>().until(str);
+
+    if (_seen[index])
+      return ParseResult<void>().fail("Duplicate field", str);
+    _seen[index] = true;
+
+    const auto value = std::string_view(str, static_cast<size_t>(end - str));
+    _current_values[index] = {static_cast<uint32_t>(str - _current_telegram), static_cast<uint32_t>(value.size())};
+    if (previous_value(index) == value)
+      return ParseResult<void>().until(end);
+
+    _changed[index] = true;
+    reset_field(index);
+    return _data.parse_field_at(index, str, end);
+  }
+
+  // The value of the field in the previous telegram, or nullopt if the field wasn't there
+  std::optional<std::string_view> previous_value(const size_t index) {
+    if (!present(index))
+      return std::nullopt;
+    return std::string_view(_telegram.data() + _values[index].offset, _values[index].size);
+  }
+
+  template <typename Field>
+  static constexpr size_t index_of() {
+    constexpr std::array<bool, number_of_fields> matches{std::is_same_v<Field, Ts>...};
+    for (size_t i = 0; i < number_of_fields; ++i) {
+      if (matches[i])
+        return i;
+    }
+    return number_of_fields;
+  }
+
+  bool present(const size_t index) {
+    static constexpr std::array<bool (*)(Data&), number_of_fields> functions{[](Data& data) { return static_cast<Ts&>(data).present(); }...};
+    return functions[index](_data);
+  }
+
+  template <size_t... I>
+  std::bitset<number_of_fields> present_fields(std::index_sequence<I...>) {
+    std::bitset<number_of_fields> fields;
+    ((fields[I] = present(I)), ...);
+    return fields;
+  }
+
+  void reset_field(const size_t index) {
+    static constexpr std::array<void (*)(Data&), number_of_fields> functions{[](Data& data) { static_cast<Ts&>(data) = Ts(); }...};
+    functions[index](_data);
+  }
+
+  void reset_fields(const std::bitset<number_of_fields>& fields) {
+    for (size_t i = 0; i < number_of_fields; ++i) {
+      if (fields[i]) {
+        reset_field(i);
+        _changed[i] = true;
+      }
+    }
+  }
+
+  template <typename F, size_t... I>
+  void apply_changed(F& f, std::index_sequence<I...>) {
+    ((_changed[I] ? static_cast<Ts&>(_data).apply(f) : void()), ...);
+  }
+};
+
+}
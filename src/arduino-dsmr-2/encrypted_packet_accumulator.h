@@ -1,4 +1,6 @@
 #pragma once
+#include "memory_instrumentation.h"
+#include "timing_stats.h"
 #include "util.h"
 #include <array>
 #include <mbedtls/gcm.h>
@@ -84,25 +86,75 @@ class EncryptedPacketAccumulator {
     std::span<const uint8_t> tag() const { return {_buffer.data() + _packetSize - 12, 12}; }
   };
 
-  class MbedTlsAes128GcmDecryptor : NonCopyableAndNonMovable {
+  // The key schedule is computed once in set_encryption_key and the context is reused for every packet.
+  class MbedTlsAes128GcmDecryptor : NonCopyable {
     mbedtls_gcm_context gcm;
+    std::array<uint8_t, 16> _key{};
+    bool _has_key = false;
 
   public:
     MbedTlsAes128GcmDecryptor() { mbedtls_gcm_init(&gcm); }
 
-    bool set_encryption_key(const std::span<const uint8_t> key) { return mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key.data(), 128) == 0; }
+    // mbedtls_gcm_context can't be moved byte by byte, so the new context computes the key schedule again
+    MbedTlsAes128GcmDecryptor(MbedTlsAes128GcmDecryptor&& other) noexcept : MbedTlsAes128GcmDecryptor() {
+      if (other._has_key)
+        set_encryption_key(other._key);
+    }
 
-    bool decrypt(std::span<const uint8_t> iv, std::span<const uint8_t> ciphertext, std::span<const uint8_t> tag, std::span<char> decrypted_output) {
-      // aad = AdditionalAuthenticatedData = SecurityControlField + AuthenticationKey.
-      //   SecurityControlField is always 0x30.
-      //   AuthenticationKey = "00112233445566778899AABBCCDDEEFF". It is hardcoded and is the same for all DSMR devices.
-      constexpr uint8_t aad[] = {0x30, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    MbedTlsAes128GcmDecryptor& operator=(MbedTlsAes128GcmDecryptor&& other) noexcept {
+      if (this != &other) {
+        mbedtls_gcm_free(&gcm);
+        mbedtls_gcm_init(&gcm);
+        _has_key = false;
+        if (other._has_key)
+          set_encryption_key(other._key);
+      }
+      return *this;
+    }
+
+    bool set_encryption_key(const std::array<uint8_t, 16>& key) {
+      _has_key = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key.data(), 128) == 0;
+      _key = key;
+      return _has_key;
+    }
+
+    bool has_encryption_key() const { return _has_key; }
+
+    // aad = AdditionalAuthenticatedData = SecurityControlField + AuthenticationKey.
+    //   SecurityControlField is always 0x30.
+    //   AuthenticationKey = "00112233445566778899AABBCCDDEEFF". It is hardcoded and is the same for all DSMR devices.
+    static constexpr uint8_t aad[] = {0x30, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
 
+    bool decrypt(std::span<const uint8_t> iv, std::span<const uint8_t> ciphertext, std::span<const uint8_t> tag, std::span<char> decrypted_output) {
       const auto& res = mbedtls_gcm_auth_decrypt(&gcm, ciphertext.size(), iv.data(), iv.size(), aad, std::size(aad), tag.data(), tag.size(), ciphertext.data(),
                                                  reinterpret_cast<unsigned char*>(decrypted_output.data()));
       return res == 0;
     }
 
+    // Incremental decryption: start(), then update_in_place() for each part of the ciphertext, then finish().
+    // All parts except the last one must be a multiple of 16 bytes, then mbedtls outputs the plaintext right away.
+    bool start(std::span<const uint8_t> iv) {
+      return mbedtls_gcm_starts(&gcm, MBEDTLS_GCM_DECRYPT, iv.data(), iv.size()) == 0 && mbedtls_gcm_update_ad(&gcm, aad, std::size(aad)) == 0;
+    }
+
+    bool update_in_place(std::span<uint8_t> data) {
+      size_t output_length = 0;
+      return mbedtls_gcm_update(&gcm, data.data(), data.size(), data.data(), data.size(), &output_length) == 0 && output_length == data.size();
+    }
+
+    // Compares the calculated tag with the received one in constant time
+    bool finish(std::span<const uint8_t> tag) {
+      std::array<uint8_t, 16> calculated_tag;
+      size_t output_length = 0;
+      if (mbedtls_gcm_finish(&gcm, nullptr, 0, &output_length, calculated_tag.data(), tag.size()) != 0)
+        return false;
+
+      uint8_t diff = 0;
+      for (size_t i = 0; i < tag.size(); ++i)
+        diff |= static_cast<uint8_t>(calculated_tag[i] ^ tag[i]);
+      return diff == 0;
+    }
+
     ~MbedTlsAes128GcmDecryptor() { mbedtls_gcm_free(&gcm); }
   };
 
@@ -112,11 +164,22 @@ class EncryptedPacketAccumulator {
   std::span<char> _raw_decrypted_telegram_buffer;
   HeaderAccumulator _header_accumulator;
   TelegramAccumulator _encrypted_telegram_accumulator;
-  std::array<uint8_t, 16> _encryption_key{};
+  MbedTlsAes128GcmDecryptor _decryptor;
+
+  // Only used when the telegram is decrypted in place while it is received
+  bool _decrypt_in_place = false;
+  std::size_t _number_of_decrypted_bytes = 0;
+  std::array<uint8_t, 12> _received_tag{};
+  std::size_t _number_of_received_tag_bytes = 0;
+
+#if DSMR_MEMORY_INSTRUMENTATION
+  std::size_t _buffer_high_water_mark = 0;
+#endif
 
 public:
   enum class Error { BufferOverflow, HeaderCorrupted, FailedToSetEncryptionKey, DecryptionFailed };
-  enum class SetEncryptionKeyError { EncryptionKeyLengthIsNot32Bytes, EncryptionKeyContainsNonHexSymbols };
+  static_assert(static_cast<std::size_t>(Error::DecryptionFailed) + 1 == TimingStats::encrypted_packet_error_count, "TimingStats counts every Error");
+  enum class SetEncryptionKeyError { EncryptionKeyLengthIsNot32Bytes, EncryptionKeyContainsNonHexSymbols, FailedToSetEncryptionKey };
 
   class Result {
     friend EncryptedPacketAccumulator;
@@ -135,7 +198,19 @@ public:
 
   explicit EncryptedPacketAccumulator(std::span<uint8_t> encrypted_packet_buffer, std::span<char> decrypted_telegram_buffer)
       : _raw_receive_encrypted_packet_buffer(encrypted_packet_buffer), _raw_decrypted_telegram_buffer(decrypted_telegram_buffer),
-        _encrypted_telegram_accumulator(encrypted_packet_buffer) {}
+        _encrypted_telegram_accumulator(encrypted_packet_buffer) {
+    // Until set_encryption_key is called, packets are decrypted with an all-zero key
+    _decryptor.set_encryption_key({});
+  }
+
+  // Uses a single buffer that only needs to fit the telegram.
+  // Every 16 bytes of the telegram are decrypted in place as soon as they are received, so the packet is ready right after the GCM tag arrives.
+  // The packet is returned only if the tag is correct. Otherwise, the buffer is wiped and DecryptionFailed is returned.
+  // The buffer is also wiped when `reset` is called in the middle of a packet.
+  explicit EncryptedPacketAccumulator(std::span<char> telegram_buffer)
+      : EncryptedPacketAccumulator(std::span<uint8_t>(reinterpret_cast<uint8_t*>(telegram_buffer.data()), telegram_buffer.size()), telegram_buffer) {
+    _decrypt_in_place = true;
+  }
 
   // key_hex is a string like "00112233445566778899AABBCCDDEEFF"
   std::optional<SetEncryptionKeyError> set_encryption_key(std::string_view key_hex) {
@@ -143,19 +218,48 @@ public:
       return SetEncryptionKeyError::EncryptionKeyLengthIsNot32Bytes;
     }
 
+    std::array<uint8_t, 16> key;
     for (size_t i = 0; i < 16; ++i) {
       const auto hi = to_hex_value(key_hex[2 * i]);
       const auto lo = to_hex_value(key_hex[2 * i + 1]);
       if (!hi || !lo) {
         return SetEncryptionKeyError::EncryptionKeyContainsNonHexSymbols;
       }
-      _encryption_key[i] = static_cast<uint8_t>((*hi << 4) | *lo);
+      key[i] = static_cast<uint8_t>((*hi << 4) | *lo);
+    }
+
+    if (!_decryptor.set_encryption_key(key)) {
+      return SetEncryptionKeyError::FailedToSetEncryptionKey;
     }
 
     return {};
   }
 
   Result process_byte(const uint8_t byte) {
+    timing::count(&TimingStats::encrypted_bytes_consumed);
+    return timing::count_result(handle_byte(byte), &TimingStats::encrypted_packets_emitted, &TimingStats::encrypted_packet_errors);
+  }
+
+  // According to the specification, packets arrive once every 10 seconds.
+  // It is possible that some bytes are lost during transmission.
+  // Thus, you need to use a timeout to detect when a packet transmission finishes.
+  // In case the transmission finished, but the `process_byte` method did not return a complete packet,
+  // you need to call this method to reset the internal state machine.
+  void reset() {
+    // A packet that is cut off was partially decrypted in place, but never authenticated, so its plaintext is wiped like in decryption_failed
+    if (_decrypt_in_place && _state == State::AccumulatingTelegramWithGcmTag)
+      std::fill_n(_raw_receive_encrypted_packet_buffer.begin(), _number_of_decrypted_bytes, uint8_t(0));
+    _state = State::WaitingForPacketStartSymbol;
+  }
+
+#if DSMR_MEMORY_INSTRUMENTATION
+  // The largest number of bytes that a packet needed in the encrypted packet buffer, including packets that were rejected with BufferOverflow.
+  // It is counted when the packet header is received, so it is known before the rest of the packet arrives.
+  std::size_t buffer_high_water_mark() const { return _buffer_high_water_mark; }
+#endif
+
+private:
+  Result handle_byte(const uint8_t byte) {
     switch (_state) {
     case State::WaitingForPacketStartSymbol:
       if (byte == 0xDB) {
@@ -176,14 +280,35 @@ public:
         return Error::HeaderCorrupted;
       }
 
-      if (_header_accumulator.telegram_with_gcm_tag_length() > static_cast<int>(_encrypted_telegram_accumulator.capacity())) {
+#if DSMR_MEMORY_INSTRUMENTATION
+      _buffer_high_water_mark = std::max(_buffer_high_water_mark, required_buffer_size());
+#endif
+      if (required_buffer_size() > _encrypted_telegram_accumulator.capacity()) {
         _state = State::WaitingForPacketStartSymbol;
         return Error::BufferOverflow;
       }
 
+      if (_decrypt_in_place) {
+        if (!_decryptor.has_encryption_key()) {
+          _state = State::WaitingForPacketStartSymbol;
+          return Error::FailedToSetEncryptionKey;
+        }
+
+        if (!timing::measure(&TimingStats::decrypt_time, [&] { return _decryptor.start(_header_accumulator.nonce()); })) {
+          _state = State::WaitingForPacketStartSymbol;
+          return Error::DecryptionFailed;
+        }
+        _number_of_decrypted_bytes = 0;
+        _number_of_received_tag_bytes = 0;
+      }
+
       _state = State::AccumulatingTelegramWithGcmTag;
       return {};
     case State::AccumulatingTelegramWithGcmTag:
+      if (_decrypt_in_place) {
+        return decrypt_in_place(byte);
+      }
+
       _encrypted_telegram_accumulator.add(byte);
 
       if (static_cast<int>(_encrypted_telegram_accumulator.number_of_accumulated_bytes()) != _header_accumulator.telegram_with_gcm_tag_length()) {
@@ -192,14 +317,14 @@ public:
 
       _state = State::WaitingForPacketStartSymbol;
 
-      MbedTlsAes128GcmDecryptor decryptor;
-
-      if (!decryptor.set_encryption_key(_encryption_key)) {
+      if (!_decryptor.has_encryption_key()) {
         return Error::FailedToSetEncryptionKey;
       }
 
-      if (!decryptor.decrypt(_header_accumulator.nonce(), _encrypted_telegram_accumulator.telegram(), _encrypted_telegram_accumulator.tag(),
-                             _raw_decrypted_telegram_buffer)) {
+      if (!timing::measure(&TimingStats::decrypt_time, [&] {
+            return _decryptor.decrypt(_header_accumulator.nonce(), _encrypted_telegram_accumulator.telegram(), _encrypted_telegram_accumulator.tag(),
+                                      _raw_decrypted_telegram_buffer);
+          })) {
         return Error::DecryptionFailed;
       }
 
@@ -210,14 +335,49 @@ public:
     return {};
   }
 
-  // According to the specification, packets arrive once every 10 seconds.
-  // It is possible that some bytes are lost during transmission.
-  // Thus, you need to use a timeout to detect when a packet transmission finishes.
-  // In case the transmission finished, but the `process_byte` method did not return a complete packet,
-  // you need to call this method to reset the internal state machine.
-  void reset() { _state = State::WaitingForPacketStartSymbol; }
+  // When decrypting in place, the GCM tag is not stored in the buffer
+  std::size_t required_buffer_size() const {
+    return static_cast<std::size_t>(_header_accumulator.telegram_with_gcm_tag_length()) - (_decrypt_in_place ? 12 : 0);
+  }
+
+  Result decrypt_in_place(const uint8_t byte) {
+    const auto telegram_length = static_cast<size_t>(_header_accumulator.telegram_with_gcm_tag_length()) - 12;
+
+    if (_encrypted_telegram_accumulator.number_of_accumulated_bytes() < telegram_length) {
+      _encrypted_telegram_accumulator.add(byte);
+
+      // Decrypt every complete 16-byte block and the last incomplete one
+      const auto received = _encrypted_telegram_accumulator.number_of_accumulated_bytes();
+      if (received - _number_of_decrypted_bytes == 16 || received == telegram_length) {
+        const auto& block = _raw_receive_encrypted_packet_buffer.subspan(_number_of_decrypted_bytes, received - _number_of_decrypted_bytes);
+        if (!timing::measure(&TimingStats::decrypt_time, [&] { return _decryptor.update_in_place(block); })) {
+          return decryption_failed();
+        }
+        _number_of_decrypted_bytes = received;
+      }
+      return {};
+    }
+
+    _received_tag[_number_of_received_tag_bytes++] = byte;
+    if (_number_of_received_tag_bytes != _received_tag.size()) {
+      return {};
+    }
+
+    if (!timing::measure(&TimingStats::decrypt_time, [&] { return _decryptor.finish(_received_tag); })) {
+      return decryption_failed();
+    }
+
+    _state = State::WaitingForPacketStartSymbol;
+    return std::string_view(_raw_decrypted_telegram_buffer.data(), telegram_length);
+  }
+
+  // The buffer contains plaintext that is not authenticated, it must not be used
+  Result decryption_failed() {
+    std::fill(_raw_receive_encrypted_packet_buffer.begin(), _raw_receive_encrypted_packet_buffer.end(), uint8_t(0));
+    _state = State::WaitingForPacketStartSymbol;
+    return Error::DecryptionFailed;
+  }
 
-private:
   static std::optional<uint8_t> to_hex_value(const char c) {
     if (c >= '0' && c <= '9')
       return static_cast<uint8_t>(c - '0');
@@ -249,6 +409,8 @@ inline const char* to_string(const EncryptedPacketAccumulator::SetEncryptionKeyE
     return "EncryptionKeyLengthIsNot32Bytes";
   case EncryptedPacketAccumulator::SetEncryptionKeyError::EncryptionKeyContainsNonHexSymbols:
     return "EncryptionKeyContainsNonHexSymbols";
+  case EncryptedPacketAccumulator::SetEncryptionKeyError::FailedToSetEncryptionKey:
+    return "FailedToSetEncryptionKey";
   }
   return "Unknown error";
 }
@@ -16,6 +16,40 @@
 #define DSMR_SUB_MBUS_ID 4
 #endif
 
+// When enabled, all fields that are defined with the std::string value type store their values
+// in a FixedString sized to the maximum length of the field. Parsing a telegram then doesn't allocate any memory on the heap.
+// Individual fields can use a FixedString regardless of this setting by defining them with a FixedString value type.
+#ifndef DSMR_FIXED_STRING_FIELDS
+#define DSMR_FIXED_STRING_FIELDS 0
+#endif
+// RawField values have no length limit in the specification. This is the capacity of their FixedString.
+#ifndef DSMR_RAW_FIELD_MAX_LENGTH
+#define DSMR_RAW_FIELD_MAX_LENGTH 512
+#endif
+
+// When enabled, all fields that are defined with the std::string value type store a std::string_view
+// that points into the data passed to P1Parser::parse. Nothing is copied or allocated.
+// Individual fields can do the same regardless of this setting by defining them with the std::string_view value type.
+//
+// Lifetime rules: the values are only valid as long as the parsed data is not modified or destroyed.
+//  - PacketAccumulator overwrites its buffer when the next packet starts ('/' is received).
+//    When packets are received with PacketAccumulator::process, the packet is only valid inside the callback.
+//  - EncryptedPacketAccumulator overwrites the decrypted telegram buffer when the next packet is decrypted.
+//  - Copying a ParsedData copies the views, not the strings.
+// Use the values (or copy them) before the buffer is reused.
+#ifndef DSMR_STRING_VIEW_FIELDS
+#define DSMR_STRING_VIEW_FIELDS 0
+#endif
+
+// When enabled, the timestamps of the fields that are defined with TimestampField and TimestampedFixedField are stored as a Timestamp
+// (seconds since 2000 and the summer time flag) instead of the YYMMDDhhmmssX string. The text is converted once, while parsing.
+// Individual fields can do the same regardless of this setting by defining them with the Timestamp or TypedTimestampedFixedValue value type.
+#ifndef DSMR_TYPED_TIMESTAMPS
+#define DSMR_TYPED_TIMESTAMPS 0
+#endif
+
+static_assert(!(DSMR_FIXED_STRING_FIELDS && DSMR_STRING_VIEW_FIELDS), "DSMR_FIXED_STRING_FIELDS and DSMR_STRING_VIEW_FIELDS can't be enabled at the same time");
+
 namespace arduino_dsmr_2 {
 
 // Superclass for data items in a P1 message.
@@ -26,27 +60,80 @@ struct ParsedField {
     f.apply(*static_cast<T*>(this));
   }
   // By defaults, fields have no unit
-  static const char* unit() { return ""; }
+  static constexpr const char* unit() { return ""; }
+  // By default, fields store the value type passed to DEFINE_FIELD as is
+  template <typename Value>
+  using value_storage = Value;
 };
 
+// The type that replaces std::string for a value of at most maxlen characters
+template <size_t maxlen>
+using configured_string =
+    std::conditional_t<DSMR_FIXED_STRING_FIELDS, FixedString<maxlen>, std::conditional_t<DSMR_STRING_VIEW_FIELDS, std::string_view, std::string>>;
+
+template <typename T>
+struct is_string_value : std::false_type {};
+template <>
+struct is_string_value<std::string> : std::true_type {};
+template <>
+struct is_string_value<std::string_view> : std::true_type {};
+template <size_t N>
+struct is_string_value<FixedString<N>> : std::true_type {};
+
+template <typename Value, size_t maxlen>
+using string_storage = std::conditional_t<std::is_same_v<Value, std::string>, configured_string<maxlen>, Value>;
+
+// Store a string into a field value. A std::string_view value points to the parsed data instead of copying it.
+template <typename String>
+void assign_string(String& dst, std::string_view value) {
+  dst.assign(value.data(), value.size());
+}
+inline void assign_string(std::string_view& dst, std::string_view value) { dst = value; }
+
+template <typename String>
+void append_string(String& dst, std::string_view value) {
+  dst.append(value.data(), value.size());
+}
+inline void append_string(std::string_view& dst, std::string_view value) { dst = value; }
+
+// Store the YYMMDDhhmmssX text of a timestamp into a field value
+template <typename String>
+void assign_timestamp(String& dst, std::string_view text) {
+  assign_string(dst, text);
+}
+inline void assign_timestamp(Timestamp& dst, std::string_view text) { dst = TimestampParser::parse(text); }
+
+// The type that stores a timestamp that is defined with the std::string value type
+using configured_timestamp = std::conditional_t<DSMR_TYPED_TIMESTAMPS, Timestamp, configured_string<13>>;
+
 template <typename T, size_t minlen, size_t maxlen>
 struct StringField : ParsedField<T> {
   ParseResult<void> parse(const char* str, const char* end) {
-    ParseResult<std::string> res = StringParser::parse_string(minlen, maxlen, str, end);
+    ParseResult<std::string_view> res = StringParser::parse_string(minlen, maxlen, str, end);
     if (!res.err)
-      static_cast<T*>(this)->val() = res.result;
+      assign_string(static_cast<T*>(this)->val(), res.result);
     return res;
   }
+
+  template <typename Value>
+  using value_storage = string_storage<Value, maxlen>;
 };
 
-// A timestamp is essentially a string using YYMMDDhhmmssX format (where
-// X is W or S for wintertime or summertime). Parsing this into a proper
-// (UNIX) timestamp is hard to do generically. Parsing it into a
-// single integer needs > 4 bytes top fit and isn't very useful (you
-// cannot really do any calculation with those values). So we just parse
-// into a string for now.
+// A timestamp is a string using YYMMDDhhmmssX format (where
+// X is W or S for wintertime or summertime). It is stored as a string,
+// or as a Timestamp that can be compared and subtracted (see DSMR_TYPED_TIMESTAMPS).
 template <typename T>
-struct TimestampField : StringField<T, 13, 13> {};
+struct TimestampField : ParsedField<T> {
+  ParseResult<void> parse(const char* str, const char* end) {
+    ParseResult<std::string_view> res = StringParser::parse_string(13, 13, str, end);
+    if (!res.err)
+      assign_timestamp(static_cast<T*>(this)->val(), res.result);
+    return res;
+  }
+
+  template <typename Value>
+  using value_storage = std::conditional_t<std::is_same_v<Value, std::string>, configured_timestamp, Value>;
+};
 
 // Value that is parsed as a three-decimal float, but stored as an
 // integer (by multiplying by 1000). Supports val() (or implicit cast to
@@ -90,29 +177,53 @@ struct FixedField : ParsedField<T> {
     return res_float;
   }
 
-  static const char* unit() { return _unit; }
-  static const char* int_unit() { return _int_unit; }
+  static constexpr const char* unit() { return _unit; }
+  static constexpr const char* int_unit() { return _int_unit; }
 };
 
-struct TimestampedFixedValue : public FixedValue {
-  std::string timestamp;
+template <typename String>
+struct BasicTimestampedFixedValue : public FixedValue {
+  String timestamp;
 };
 
+using TimestampedFixedValue = BasicTimestampedFixedValue<std::string>;
+using TypedTimestampedFixedValue = BasicTimestampedFixedValue<Timestamp>;
+
+template <typename T>
+struct is_timestamped_value : std::false_type {};
+template <typename String>
+struct is_timestamped_value<BasicTimestampedFixedValue<String>> : std::true_type {};
+
+// True if ParsedData has a field that points into the parsed telegram instead of storing a copy (DSMR_STRING_VIEW_FIELDS).
+// Such data is only valid while the telegram is, so the parsers that reuse or overwrite their buffers reject it.
+template <typename T>
+struct is_string_view_value : std::is_same<T, std::string_view> {};
+template <typename String>
+struct is_string_view_value<BasicTimestampedFixedValue<String>> : is_string_view_value<String> {};
+
+template <typename Data>
+struct has_string_view_fields;
+template <typename... Ts>
+struct has_string_view_fields<ParsedData<Ts...>> : std::bool_constant<(is_string_view_value<typename Ts::value_type>::value || ...)> {};
+
 // Some numerical values are prefixed with a timestamp. This is simply
 // both of them concatenated, e.g. 0-1:24.2.1(150117180000W)(00473.789*m3)
 template <typename T, const char* _unit, const char* _int_unit>
 struct TimestampedFixedField : public FixedField<T, _unit, _int_unit> {
   ParseResult<void> parse(const char* str, const char* end) {
     // First, parse timestamp
-    ParseResult<std::string> res = StringParser::parse_string(13, 13, str, end);
+    ParseResult<std::string_view> res = StringParser::parse_string(13, 13, str, end);
     if (res.err)
       return res;
 
-    static_cast<T*>(this)->val().timestamp = res.result;
+    assign_timestamp(static_cast<T*>(this)->val().timestamp, res.result);
 
     // Which is immediately followed by the numerical value
     return FixedField<T, _unit, _int_unit>::parse(res.next, end);
   }
+
+  template <typename Value>
+  using value_storage = std::conditional_t<std::is_same_v<Value, TimestampedFixedValue>, BasicTimestampedFixedValue<configured_timestamp>, Value>;
 };
 
 // Take the last value of multiple values
@@ -123,7 +234,7 @@ struct LastFixedField : public FixedField<T, _unit, _int_unit> {
     // we parse last entry 2 times
     const char* last = end;
 
-    ParseResult<std::string> res;
+    ParseResult<std::string_view> res;
     res.next = str;
 
     while (res.next != end) {
@@ -153,7 +264,7 @@ struct IntField : ParsedField<T> {
     return res;
   }
 
-  static const char* unit() { return _unit; }
+  static constexpr const char* unit() { return _unit; }
 };
 
 // Take the average value of multiple values. Example:
@@ -221,10 +332,18 @@ struct AveragedFixedField : public FixedField<T, _unit, _int_unit> {
 template <typename T>
 struct RawField : ParsedField<T> {
   ParseResult<void> parse(const char* str, const char* end) {
+    auto& dst = static_cast<T*>(this)->val();
+    const auto& len = static_cast<size_t>(end - str);
+    if (len > dst.max_size() - dst.size())
+      return ParseResult<void>().fail("Invalid string length", str);
+
     // Just copy the string verbatim value without any parsing
-    static_cast<T*>(this)->val().append(str, static_cast<size_t>(end - str));
+    append_string(dst, std::string_view(str, len));
     return ParseResult<void>().until(end);
   }
+
+  template <typename Value>
+  using value_storage = string_storage<Value, DSMR_RAW_FIELD_MAX_LENGTH>;
 };
 
 namespace fields {
@@ -260,14 +379,17 @@ const uint8_t WATER_MBUS_ID = DSMR_WATER_MBUS_ID;
 const uint8_t THERMAL_MBUS_ID = DSMR_THERMAL_MBUS_ID;
 const uint8_t SUB_MBUS_ID = DSMR_SUB_MBUS_ID;
 
-#define DEFINE_FIELD(fieldname, value_t, obis, field_t, ...) \
-  struct fieldname : field_t<fieldname, ##__VA_ARGS__> {     \
-    value_t fieldname;                                       \
-    bool fieldname##_present = false;                        \
-    static inline constexpr ObisId id = obis;                \
-    static inline constexpr char name[] = #fieldname;        \
-    value_t& val() { return fieldname; }                     \
-    bool& present() { return fieldname##_present; }          \
+#define DEFINE_FIELD(fieldname, value_t, obis, field_t, ...)                               \
+  struct fieldname : field_t<fieldname, ##__VA_ARGS__> {                                   \
+    using value_type = field_t<fieldname, ##__VA_ARGS__>::template value_storage<value_t>; \
+    value_type fieldname;                                                                  \
+    bool fieldname##_present = false;                                                      \
+    static inline constexpr ObisId id = obis;                                              \
+    static inline constexpr char name[] = #fieldname;                                      \
+    value_type& val() { return fieldname; }                                                \
+    const value_type& val() const { return fieldname; }                                    \
+    bool& present() { return fieldname##_present; }                                        \
+    bool present() const { return fieldname##_present; }                                   \
   }
 
 // Meter identification. This is not a normal field, but a specially-formatted first line of the message
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace arduino_dsmr_2 {
+
+// Writes ParsedData as a JSON object into a buffer of the caller, without allocating memory. Fields that are not present are skipped:
+//   {"identification":"KFM5KAIFA-METER","power_delivered":0.333,"electricity_failures":8}
+// With units, the fields that have a unit become an object:
+//   {"identification":"KFM5KAIFA-METER","power_delivered":{"value":0.333,"unit":"kW"},"electricity_failures":8}
+// TimestampedFixedValue fields are always an object: {"value":473.789,"timestamp":"150117180000W"}
+// With units, the object also has the unit: {"value":473.789,"unit":"m3","timestamp":"150117180000W"}
+//
+// The keys, units and punctuation around every value are concatenated at compile time, so a field takes one memcpy plus its value.
+// FixedValue fields are written with 3 decimals, the precision they are stored with (671.578, 0.000), without going through float.
+// Strings are escaped, the bytes >= 0x80 are copied as is.
+struct JsonWriter {
+  // Returns the size of the JSON object, or 0 if it doesn't fit into out. The output is not null-terminated.
+  template <typename... Ts>
+  static size_t write(const ParsedData<Ts...>& data, std::span<char> out, const bool with_units = false) {
+    Writer writer(out);
+    writer.byte('{');
+    bool first = true;
+    if (with_units)
+      (write_field<Ts, true>(writer, data, first), ...);
+    else
+      (write_field<Ts, false>(writer, data, first), ...);
+    writer.byte('}');
+    return writer.overflow() ? 0 : writer.size();
+  }
+
+private:
+  class Writer {
+    char* _begin;
+    char* _pos;
+    char* _end;
+    bool _overflow = false;
+
+  public:
+    explicit Writer(std::span<char> out) : _begin(out.data()), _pos(out.data()), _end(out.data() + out.size()) {}
+
+    bool overflow() const { return _overflow; }
+    size_t size() const { return static_cast<size_t>(_pos - _begin); }
+
+    void byte(const char value) {
+      if (_pos == _end) {
+        _overflow = true;
+        return;
+      }
+      *_pos++ = value;
+    }
+
+    void bytes(const std::string_view value) {
+      if (value.size() > static_cast<size_t>(_end - _pos)) {
+        _overflow = true;
+        return;
+      }
+      if (value.empty())
+        return; // value.data() can be null
+      std::memcpy(_pos, value.data(), value.size());
+      _pos += value.size();
+    }
+
+    template <typename T>
+    void integer(const T value) {
+      const auto res = std::to_chars(_pos, _end, value);
+      if (res.ec != std::errc()) {
+        _overflow = true;
+        return;
+      }
+      _pos = res.ptr;
+    }
+
+    void fixed(const uint32_t value) {
+      integer(value / 1000);
+      if (_end - _pos < 4) {
+        _overflow = true;
+        return;
+      }
+      const auto decimals = value % 1000;
+      _pos[0] = '.';
+      _pos[1] = static_cast<char>('0' + decimals / 100);
+      _pos[2] = static_cast<char>('0' + decimals / 10 % 10);
+      _pos[3] = static_cast<char>('0' + decimals % 10);
+      _pos += 4;
+    }
+
+    void string(const std::string_view value) {
+      byte('"');
+      size_t copied = 0;
+      for (size_t i = 0; i < value.size(); ++i) {
+        const auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+          continue;
+
+        bytes(value.substr(copied, i - copied));
+        copied = i + 1;
+        if (c == '"' || c == '\\') {
+          const char escaped[] = {'\\', static_cast<char>(c)};
+          bytes(std::string_view(escaped, sizeof(escaped)));
+        } else {
+          static constexpr char hex[] = "0123456789abcdef";
+          const char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+          bytes(std::string_view(escaped, sizeof(escaped)));
+        }
+      }
+      bytes(value.substr(copied));
+      byte('"');
+    }
+  };
+
+  template <size_t N>
+  struct Fragment {
+    std::array<char, N> chars{};
+    constexpr std::string_view view() const { return std::string_view(chars.data(), N); }
+  };
+
+  template <size_t N>
+  static constexpr Fragment<N> join(const std::array<std::string_view, 4>& parts) {
+    Fragment<N> result;
+    size_t pos = 0;
+    for (const auto part : parts) {
+      for (const char c : part)
+        result.chars[pos++] = c;
+    }
+    return result;
+  }
+
+  static constexpr size_t joined_size(const std::array<std::string_view, 4>& parts) {
+    return parts[0].size() + parts[1].size() + parts[2].size() + parts[3].size();
+  }
+
+  // The text before the value of a field (starting with the comma that separates it from the previous field) and after the value
+  template <typename Field, bool with_units>
+  struct Fragments {
+    static constexpr std::string_view unit = with_units ? std::string_view(Field::unit()) : std::string_view();
+    static constexpr bool timestamped = is_timestamped_value<typename Field::value_type>::value;
+    static constexpr bool object = timestamped || !unit.empty();
+
+    static constexpr std::array<std::string_view, 4> before_parts{",\"", Field::name, "\":", object ? "{\"value\":" : ""};
+    static constexpr std::array<std::string_view, 4> after_parts{unit.empty() ? "" : ",\"unit\":\"", unit, unit.empty() ? "" : "\"",
+                                                                 timestamped ? ",\"timestamp\":" : (object ? "}" : "")};
+    static constexpr auto before = join<joined_size(before_parts)>(before_parts);
+    static constexpr auto after = join<joined_size(after_parts)>(after_parts);
+  };
+
+  // A Timestamp is written as its YYMMDDhhmmssX text, like the string that is stored without DSMR_TYPED_TIMESTAMPS, or null if it is invalid
+  template <typename String>
+  static void write_timestamp(Writer& writer, const String& timestamp) {
+    writer.string(std::string_view(timestamp));
+  }
+  static void write_timestamp(Writer& writer, const Timestamp& timestamp) {
+    if (!timestamp.valid())
+      return writer.bytes("null");
+    const auto text = timestamp.text();
+    writer.string(std::string_view(text.data(), text.size()));
+  }
+
+  template <typename Field, bool with_units, typename... Ts>
+  static void write_field(Writer& writer, const ParsedData<Ts...>& data, bool& first) {
+    const Field& field = data;
+    if (!field.present())
+      return;
+
+    using F = Fragments<Field, with_units>;
+    writer.bytes(F::before.view().substr(first ? 1 : 0));
+    first = false;
+
+    const auto& value = field.val();
+    using Value = typename Field::value_type;
+    if constexpr (std::is_same_v<Value, FixedValue> || is_timestamped_value<Value>::value) {
+      writer.fixed(value.int_val());
+    } else if constexpr (std::is_integral_v<Value>) {
+      writer.integer(value);
+    } else if constexpr (std::is_same_v<Value, Timestamp>) {
+      write_timestamp(writer, value);
+    } else {
+      static_assert(is_string_value<Value>::value, "The value type of the field is not supported");
+      writer.string(std::string_view(value));
+    }
+
+    if constexpr (!F::after.view().empty())
+      writer.bytes(F::after.view());
+    if constexpr (F::timestamped) {
+      write_timestamp(writer, value.timestamp);
+      writer.byte('}');
+    }
+  }
+};
+
+}
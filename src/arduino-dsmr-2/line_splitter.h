@@ -0,0 +1,272 @@
+#pragma once
+
+#include "util.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSMR_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define DSMR_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DSMR_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace arduino_dsmr_2 {
+
+// The data lines of a telegram are delimited by only four "structural" symbols: '\r', '\n', '(' and ')'.
+// A structural scanner looks at a block of bytes at once and returns a mask with a set bit for every structural symbol.
+// All scanners have the same interface:
+//   static constexpr std::size_t block_size;
+//   static mask_t scan(const char* block);           // reads exactly block_size bytes
+//   static std::size_t first_index(mask_t mask);     // position of the first structural symbol in the block
+//   static mask_t clear_first(mask_t mask);          // removes the first structural symbol from the mask
+//
+// ScalarStructuralScanner - portable SWAR implementation, processes one machine word at a time.
+// Sse2StructuralScanner   - 16 bytes at a time. Available on all x86-64 CPUs.
+// Avx2StructuralScanner   - 32 bytes at a time. Available when the code is compiled with AVX2 support (e.g. -mavx2 or /arch:AVX2).
+// NeonStructuralScanner   - 16 bytes at a time. Available on ARM CPUs with NEON (e.g. aarch64).
+//
+// The fastest available scanner is used by default. It can be changed with the DSMR_STRUCTURAL_SCANNER macro.
+struct ScalarStructuralScanner {
+  using mask_t = std::size_t;
+  static constexpr std::size_t block_size = sizeof(mask_t);
+
+  static mask_t scan(const char* block) {
+    const mask_t word = load(block);
+    return matches(word, '\r') | matches(word, '\n') | matches(word, '(') | matches(word, ')');
+  }
+
+  static std::size_t first_index(const mask_t mask) {
+    if constexpr (std::endian::native == std::endian::little)
+      return static_cast<std::size_t>(std::countr_zero(mask)) / 8;
+    else
+      return static_cast<std::size_t>(std::countl_zero(mask)) / 8;
+  }
+
+  static mask_t clear_first(const mask_t mask) {
+    if constexpr (std::endian::native == std::endian::little)
+      return mask & (mask - 1);
+    else
+      return mask & ~(std::bit_floor(mask));
+  }
+
+private:
+  static constexpr mask_t ones = ~mask_t(0) / 0xFF;
+  static constexpr mask_t low_bits = ones * 0x7F;
+
+  static mask_t load(const char* block) {
+    mask_t word;
+    std::memcpy(&word, block, sizeof(word));
+    return word;
+  }
+
+  // Sets the high bit of every byte of the word that is equal to c. Unlike the well known "has zero byte" trick,
+  // there are no false positives: the additions can not carry into the next byte.
+  static mask_t matches(const mask_t word, const char c) {
+    const mask_t x = word ^ (ones * static_cast<uint8_t>(c));
+    return ~(((x & low_bits) + low_bits) | x | low_bits);
+  }
+};
+
+#ifdef DSMR_HAS_SSE2
+struct Sse2StructuralScanner {
+  using mask_t = uint32_t;
+  static constexpr std::size_t block_size = 16;
+
+  static mask_t scan(const char* block) {
+    __m128i v;
+    std::memcpy(&v, block, sizeof(v));
+    const __m128i newlines = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('(')), _mm_cmpeq_epi8(v, _mm_set1_epi8(')')));
+    return static_cast<mask_t>(_mm_movemask_epi8(_mm_or_si128(newlines, brackets)));
+  }
+
+  static std::size_t first_index(const mask_t mask) { return static_cast<std::size_t>(std::countr_zero(mask)); }
+  static mask_t clear_first(const mask_t mask) { return mask & (mask - 1); }
+};
+#endif
+
+#ifdef DSMR_HAS_AVX2
+struct Avx2StructuralScanner {
+  using mask_t = uint32_t;
+  static constexpr std::size_t block_size = 32;
+
+  static mask_t scan(const char* block) {
+    __m256i v;
+    std::memcpy(&v, block, sizeof(v));
+    const __m256i newlines = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+    const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')')));
+    return static_cast<mask_t>(_mm256_movemask_epi8(_mm256_or_si256(newlines, brackets)));
+  }
+
+  static std::size_t first_index(const mask_t mask) { return static_cast<std::size_t>(std::countr_zero(mask)); }
+  static mask_t clear_first(const mask_t mask) { return mask & (mask - 1); }
+};
+#endif
+
+#ifdef DSMR_HAS_NEON
+struct NeonStructuralScanner {
+  using mask_t = uint64_t;
+  static constexpr std::size_t block_size = 16;
+
+  // NEON has no movemask instruction. Instead, the comparison result is narrowed to 4 bits per byte,
+  // and only the highest of these 4 bits is kept.
+  static mask_t scan(const char* block) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(block));
+    const uint8x16_t newlines = vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')), vceqq_u8(v, vdupq_n_u8('\n')));
+    const uint8x16_t brackets = vorrq_u8(vceqq_u8(v, vdupq_n_u8('(')), vceqq_u8(v, vdupq_n_u8(')')));
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(vorrq_u8(newlines, brackets)), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+  }
+
+  static std::size_t first_index(const mask_t mask) { return static_cast<std::size_t>(std::countr_zero(mask)) / 4; }
+  static mask_t clear_first(const mask_t mask) { return mask & (mask - 1); }
+};
+#endif
+
+#ifndef DSMR_STRUCTURAL_SCANNER
+#if defined(DSMR_HAS_AVX2)
+#define DSMR_STRUCTURAL_SCANNER Avx2StructuralScanner
+#elif defined(DSMR_HAS_SSE2)
+#define DSMR_STRUCTURAL_SCANNER Sse2StructuralScanner
+#elif defined(DSMR_HAS_NEON)
+#define DSMR_STRUCTURAL_SCANNER NeonStructuralScanner
+#else
+#define DSMR_STRUCTURAL_SCANNER ScalarStructuralScanner
+#endif
+#endif
+
+using StructuralScanner = DSMR_STRUCTURAL_SCANNER;
+
+// Iterates over the positions of the structural symbols in [begin, end).
+// The string is scanned one block at a time. The last incomplete block is copied into a zero-padded buffer.
+template <typename Scanner>
+class StructuralIterator {
+  using mask_t = typename Scanner::mask_t;
+  static constexpr auto block_size = static_cast<std::ptrdiff_t>(Scanner::block_size);
+
+  const char* _block;
+  const char* _end;
+  mask_t _mask = 0;
+
+  void scan_block() {
+    if (_end - _block >= block_size) {
+      _mask = Scanner::scan(_block);
+      return;
+    }
+
+    char tail[Scanner::block_size] = {};
+    std::memcpy(tail, _block, static_cast<std::size_t>(_end - _block));
+    _mask = Scanner::scan(tail);
+  }
+
+public:
+  StructuralIterator(const char* begin, const char* end) : _block(begin), _end(end) {
+    if (_block < _end)
+      scan_block();
+  }
+
+  // Returns the position of the next structural symbol or end if there are no more.
+  const char* next() {
+    while (_mask == 0) {
+      if (_end - _block <= block_size)
+        return _end;
+      _block += block_size;
+      scan_block();
+    }
+
+    const char* res = _block + Scanner::first_index(_mask);
+    _mask = Scanner::clear_first(_mask);
+    return res;
+  }
+};
+
+// Splits the data lines of a telegram into logical lines and calls on_line(line_start, line_end) for each of them.
+// on_line returns ParseResult<void>. Splitting stops at the first error.
+// A value can be split across physical lines. We need to track brackets to handle cases like:
+//   0-0:96.13.0(303132333435
+//   30313233343)
+// and look ahead after a line break to handle cases like:
+//   0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)
+//   (00124.477)
+template <typename Scanner = StructuralScanner, typename OnLine>
+ParseResult<void> split_logical_lines(const char* str, const char* end, OnLine&& on_line) {
+  StructuralIterator<Scanner> it(str, end);
+  const char* line_start = str;
+  bool open_bracket_found = false;
+
+  for (const char* p = it.next(); p != end; p = it.next()) {
+    switch (*p) {
+    case '(':
+      if (open_bracket_found)
+        return ParseResult<void>().fail("Unexpected '(' symbol", p);
+      open_bracket_found = true;
+      break;
+    case ')':
+      if (!open_bracket_found)
+        return ParseResult<void>().fail("Unexpected ')' symbol", p);
+      open_bracket_found = false;
+      break;
+    default: {
+      // '\r' or '\n'
+      const bool next_part_of_the_data_line_on_next_line = (end - p > 2) && (p[1] == '(' || p[2] == '(');
+      if (open_bracket_found || next_part_of_the_data_line_on_next_line)
+        break;
+
+      // End of logical line -> parse it
+      ParseResult<void> tmp = on_line(line_start, p);
+      if (tmp.err)
+        return tmp;
+      line_start = p + 1;
+    }
+    }
+  }
+
+  if (end != line_start)
+    return ParseResult<void>().fail("Last dataline not CRLF terminated", end);
+
+  return ParseResult<void>();
+}
+
+// Finds the end of the logical line that starts at str, by the same rules as split_logical_lines.
+// On success, `next` points to the line break that ends the line.
+template <typename Scanner = StructuralScanner>
+ParseResult<void> find_logical_line_end(const char* str, const char* end) {
+  StructuralIterator<Scanner> it(str, end);
+  bool open_bracket_found = false;
+
+  for (const char* p = it.next(); p != end; p = it.next()) {
+    switch (*p) {
+    case '(':
+      if (open_bracket_found)
+        return ParseResult<void>().fail("Unexpected '(' symbol", p);
+      open_bracket_found = true;
+      break;
+    case ')':
+      if (!open_bracket_found)
+        return ParseResult<void>().fail("Unexpected ')' symbol", p);
+      open_bracket_found = false;
+      break;
+    default: {
+      // '\r' or '\n'
+      const bool next_part_of_the_data_line_on_next_line = (end - p > 2) && (p[1] == '(' || p[2] == '(');
+      if (!open_bracket_found && !next_part_of_the_data_line_on_next_line)
+        return ParseResult<void>().until(p);
+    }
+    }
+  }
+
+  return ParseResult<void>().fail("Last dataline not CRLF terminated", end);
+}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Optional instrumentation that shows how much memory the library uses. It is enabled with DSMR_MEMORY_INSTRUMENTATION=1.
+// When it is disabled, nothing is recorded and the parser and the accumulators are compiled exactly as without it.
+//
+// What is recorded:
+//   memory_instrumentation::parser_stats()  - heap allocations made by P1Parser::parse calls of the current thread.
+//   buffer_high_water_mark()                - the largest packet that PacketAccumulator/EncryptedPacketAccumulator had to fit into its buffer.
+//   ParsedData<...>::field_footprints()     - sizeof of every field (available even without the instrumentation).
+//
+// The library can't see heap allocations on its own. They are counted by a replacement of the global operator new
+// that is defined when DSMR_MEMORY_INSTRUMENTATION_IMPLEMENT_ALLOCATION_HOOKS is defined before including this header
+// in exactly one source file of the program. A program that already replaces operator new can call
+// memory_instrumentation::record_allocation from its own implementation instead.
+#ifndef DSMR_MEMORY_INSTRUMENTATION
+#define DSMR_MEMORY_INSTRUMENTATION 0
+#endif
+
+namespace arduino_dsmr_2 {
+
+struct AllocationStats {
+  std::size_t allocations = 0;
+  std::size_t bytes = 0;
+};
+
+struct ParserMemoryStats {
+  std::size_t parse_calls = 0;
+  AllocationStats last;  // the last P1Parser::parse call
+  AllocationStats max;   // the maximum of a single P1Parser::parse call, allocations and bytes are tracked separately
+  AllocationStats total; // all P1Parser::parse calls
+};
+
+struct FieldFootprint {
+  const char* name;
+  std::size_t size;
+};
+
+namespace memory_instrumentation {
+
+// All counters are per thread, so they don't need synchronization and allocations of other threads don't get mixed in.
+inline AllocationStats& thread_allocations() {
+  thread_local AllocationStats stats;
+  return stats;
+}
+
+inline ParserMemoryStats& parser_stats() {
+  thread_local ParserMemoryStats stats;
+  return stats;
+}
+
+inline void record_allocation(const std::size_t size) {
+  auto& stats = thread_allocations();
+  stats.allocations++;
+  stats.bytes += size;
+}
+
+#if DSMR_MEMORY_INSTRUMENTATION
+// Adds the allocations made during its lifetime to parser_stats()
+class ParseScope {
+  AllocationStats _at_start = thread_allocations();
+
+public:
+  ParseScope() = default;
+  ParseScope(const ParseScope&) = delete;
+  ParseScope& operator=(const ParseScope&) = delete;
+
+  ~ParseScope() {
+    const auto& now = thread_allocations();
+    auto& stats = parser_stats();
+    stats.parse_calls++;
+    stats.last = {now.allocations - _at_start.allocations, now.bytes - _at_start.bytes};
+    stats.max = {std::max(stats.max.allocations, stats.last.allocations), std::max(stats.max.bytes, stats.last.bytes)};
+    stats.total = {stats.total.allocations + stats.last.allocations, stats.total.bytes + stats.last.bytes};
+  }
+};
+#else
+class ParseScope {
+public:
+  ParseScope() = default;
+  ParseScope(const ParseScope&) = delete;
+  ParseScope& operator=(const ParseScope&) = delete;
+};
+#endif
+
+}
+
+}
+
+#if DSMR_MEMORY_INSTRUMENTATION && defined(DSMR_MEMORY_INSTRUMENTATION_IMPLEMENT_ALLOCATION_HOOKS)
+// The array and nothrow forms of operator new and delete call these by default
+void* operator new(const std::size_t size) {
+  arduino_dsmr_2::memory_instrumentation::record_allocation(size);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
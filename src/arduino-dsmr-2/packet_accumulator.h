@@ -1,6 +1,12 @@
 #pragma once
+#include "crc16.h"
+#include "memory_instrumentation.h"
+#include "timing_stats.h"
 #include "util.h"
+#include <bit>
+#include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <string_view>
 #include <span>
@@ -9,35 +15,60 @@ namespace arduino_dsmr_2 {
 
 // Receives unencrypted DSMR packets.
 class PacketAccumulator {
+  // Stores the packet and calculates its CRC16 while the bytes are added,
+  // so the CRC check at the end of the packet is a single comparison.
   class DsmrPacketBuffer {
     std::span<char> _buffer;
     std::size_t _packetSize = 0;
+    uint16_t _crc = 0;
+    bool _calculate_crc;
+#if DSMR_MEMORY_INSTRUMENTATION
+    std::size_t _high_water_mark = 0;
+#endif
 
   public:
-    explicit DsmrPacketBuffer(std::span<char> buffer) : _buffer{buffer} {}
+    DsmrPacketBuffer(std::span<char> buffer, bool calculate_crc) : _buffer{buffer}, _calculate_crc(calculate_crc) {}
 
     std::string_view packet() const { return std::string_view(_buffer.data(), _packetSize); }
 
+    void set_buffer(std::span<char> buffer) {
+      _buffer = buffer;
+      reset();
+    }
+
+    void reset() {
+      _packetSize = 0;
+      _crc = 0;
+    }
+
     void add(char byte) {
       _buffer[_packetSize] = byte;
       _packetSize++;
+      if (_calculate_crc)
+        _crc = Crc16::update(_crc, static_cast<uint8_t>(byte));
+#if DSMR_MEMORY_INSTRUMENTATION
+      _high_water_mark = std::max(_high_water_mark, _packetSize);
+#endif
+    }
+
+    void add(const char* bytes, std::size_t size) {
+      std::memcpy(_buffer.data() + _packetSize, bytes, size);
+      _packetSize += size;
+      if (_calculate_crc)
+        _crc = timing::measure(&TimingStats::crc_time, [&] { return Crc16Bulk::update(_crc, bytes, size); });
+#if DSMR_MEMORY_INSTRUMENTATION
+      _high_water_mark = std::max(_high_water_mark, _packetSize);
+#endif
     }
 
     bool has_space() const { return _packetSize < _buffer.size(); }
+    std::size_t free_space() const { return _buffer.size() - _packetSize; }
 
-    uint16_t calculate_crc16() const {
-      uint16_t crc = 0;
-      for (std::size_t i = 0; i < _packetSize; ++i) {
-        crc ^= static_cast<uint8_t>(_buffer[i]);
-        for (std::size_t bit = 0; bit < 8; bit++) {
-          if (crc & 1)
-            crc = (crc >> 1) ^ 0xa001;
-          else
-            crc = (crc >> 1);
-        }
-      }
-      return crc;
-    }
+    uint16_t crc16() const { return _crc; }
+
+#if DSMR_MEMORY_INSTRUMENTATION
+    std::size_t high_water_mark() const { return _high_water_mark; }
+#endif
   };
 
   class CrcAccumulator {
@@ -68,10 +99,13 @@ class PacketAccumulator {
 
   enum class State { WaitingForPacketStartSymbol, WaitingForPacketEndSymbol, WaitingForCrc };
   State _state = State::WaitingForPacketStartSymbol;
-  std::span<char> _raw_buffer;
   DsmrPacketBuffer _buf;
   CrcAccumulator _crc_accumulator;
   bool _check_crc;
+  // Rotating mode only
+  std::span<const std::span<char>> _buffers;
+  std::size_t _current_buffer = 0;
+  uint64_t _free_buffers = 0; // a bit for every buffer that isn't written to or held by the caller
 
 public:
   enum class Error {
@@ -79,7 +113,9 @@ public:
     PacketStartSymbolInPacket,
     IncorrectCrcCharacter,
     CrcMismatch,
+    NoFreeBuffer, // rotating mode only: the caller holds all other buffers, so the packet was dropped
   };
+  static_assert(static_cast<std::size_t>(Error::NoFreeBuffer) + 1 == TimingStats::packet_error_count, "TimingStats counts every Error");
 
   class Result {
     friend class PacketAccumulator;
@@ -96,11 +132,93 @@ public:
     auto error() const { return _error; }
   };
 
-  PacketAccumulator(std::span<char> buffer, bool check_crc) : _raw_buffer(buffer), _buf(buffer), _check_crc(check_crc) {}
+  PacketAccumulator(std::span<char> buffer, bool check_crc) : _buf(buffer, check_crc), _check_crc(check_crc) {}
+
+  // Rotating mode: every packet is written to one of the `buffers` (2 to 64) and stays valid until it is given back with `release_packet`.
+  // In the meantime the accumulator receives the next packets into the other buffers, so a slow consumer doesn't have to copy the packet.
+  // If the caller holds all other buffers when a packet is complete, the packet is dropped (NoFreeBuffer) and its buffer is reused.
+  // Not only the buffers but also the `buffers` array must outlive the accumulator.
+  static PacketAccumulator rotating(std::span<const std::span<char>> buffers, bool check_crc) { return PacketAccumulator(RotatingTag(), buffers, check_crc); }
 
   Result process_byte(const char byte) {
+    timing::count(&TimingStats::bytes_consumed);
+    return timing::count_result(handle_byte(byte), &TimingStats::packets_emitted, &TimingStats::packet_errors);
+  }
+
+  // Feeds a chunk of bytes to the accumulator.
+  // The result is the same as calling `process_byte` for every byte of the chunk, but the bytes between the packet start and end symbols
+  // are found with `memchr` and copied to the buffer with `memcpy` instead of going through the state machine one by one.
+  // `on_result` is called with every Result that contains a packet or an error, in the order they occur.
+  // Note: the packet passed to `on_result` is overwritten by the next packet in the same chunk, so it has to be consumed inside the callback.
+  // In rotating mode the packet stays valid until it is released.
+  template <typename Callback>
+  void process(std::span<const char> bytes, Callback&& on_result) {
+    timing::count(&TimingStats::bytes_consumed, bytes.size());
+
+    const char* p = bytes.data();
+    const char* const end = p + bytes.size();
+
+    while (p < end) {
+      if (_buf.has_space()) {
+        if (_state == State::WaitingForPacketStartSymbol) {
+          // Skip everything before the packet start symbol
+          p = find(p, end, '/');
+          if (p == end) {
+            return;
+          }
+        } else if (_state == State::WaitingForPacketEndSymbol) {
+          // Copy everything up to the next '/' or '!' symbol as long as it fits into the buffer
+          const auto max_run_length = static_cast<std::ptrdiff_t>(_buf.free_space());
+          const char* const run_end = end - p > max_run_length ? p + max_run_length : end;
+          const char* const stop = find(p, find(p, run_end, '!'), '/');
+          _buf.add(p, static_cast<std::size_t>(stop - p));
+          p = stop;
+          if (p == end) {
+            return;
+          }
+        }
+      }
+
+      // The special symbols, the CRC and the buffer overflow are handled by the byte state machine
+      const auto res = timing::count_result(handle_byte(*p++), &TimingStats::packets_emitted, &TimingStats::packet_errors);
+      if (res.packet() || res.error()) {
+        on_result(res);
+      }
+    }
+  }
+
+  // Rotating mode only. Gives the buffer of a packet returned by this accumulator back, so it can receive a new packet.
+  // The buffer bookkeeping isn't synchronized, so it must be called from the same thread as `process`. PacketPipeline passes the buffers of
+  // another thread through a lock-free ring.
+  void release_packet(const std::string_view packet) {
+    for (std::size_t i = 0; i < _buffers.size(); ++i) {
+      if (_buffers[i].data() == packet.data() && i != _current_buffer)
+        _free_buffers |= uint64_t{1} << i;
+    }
+  }
+
+#if DSMR_MEMORY_INSTRUMENTATION
+  // The largest number of bytes that were stored in the buffer. If it is equal to the buffer size, a packet didn't fit (BufferOverflow).
+  std::size_t buffer_high_water_mark() const { return _buf.high_water_mark(); }
+#endif
+
+private:
+  // A named factory instead of a constructor overload, so `PacketAccumulator({}, true)` isn't ambiguous
+  struct RotatingTag {};
+
+  PacketAccumulator(RotatingTag, std::span<const std::span<char>> buffers, bool check_crc)
+      : _buf(buffers.empty() ? std::span<char>() : buffers[0], check_crc), _check_crc(check_crc),
+        _buffers(buffers.first(std::min<std::size_t>(buffers.size(), 64))) {
+    // One buffer receives the next packet while the caller holds another one, and the free buffers are the bits of a uint64_t
+    assert(buffers.size() >= 2 && buffers.size() <= 64);
+    // The first buffer receives the first packet, the others are free
+    for (std::size_t i = 1; i < _buffers.size(); ++i)
+      _free_buffers |= uint64_t{1} << i;
+  }
+
+  Result handle_byte(const char byte) {
     if (!_buf.has_space()) {
-      _buf = DsmrPacketBuffer(_raw_buffer);
+      _buf.reset();
       _state = State::WaitingForPacketStartSymbol;
       if (byte != '/') {
         return Error::BufferOverflow;
@@ -108,7 +226,7 @@ public:
     }
 
     if (byte == '/') {
-      _buf = DsmrPacketBuffer(_raw_buffer);
+      _buf.reset();
       _buf.add(byte);
       const auto prev_state = _state;
       _state = State::WaitingForPacketEndSymbol;
@@ -132,7 +250,7 @@ public:
 
       if (!_check_crc) {
         _state = State::WaitingForPacketStartSymbol;
-        return Result(_buf.packet());
+        return complete_packet();
       }
 
       _state = State::WaitingForCrc;
@@ -151,8 +269,8 @@ public:
 
       _state = State::WaitingForPacketStartSymbol;
 
-      if (_crc_accumulator.crc_value() == _buf.calculate_crc16()) {
-        return _buf.packet();
+      if (_crc_accumulator.crc_value() == _buf.crc16()) {
+        return complete_packet();
       }
 
       return Error::CrcMismatch;
@@ -161,6 +279,25 @@ public:
     // unreachable
     return {};
   }
+
+  // In rotating mode the packet is handed over to the caller and the accumulator continues with a free buffer
+  Result complete_packet() {
+    const auto packet = _buf.packet();
+    if (_buffers.empty())
+      return packet;
+    if (_free_buffers == 0)
+      return Error::NoFreeBuffer;
+
+    _current_buffer = static_cast<std::size_t>(std::countr_zero(_free_buffers));
+    _free_buffers &= _free_buffers - 1;
+    _buf.set_buffer(_buffers[_current_buffer]);
+    return packet;
+  }
+
+  static const char* find(const char* begin, const char* end, const char byte) {
+    const auto found = std::memchr(begin, byte, static_cast<std::size_t>(end - begin));
+    return found ? static_cast<const char*>(found) : end;
+  }
 };
 
 inline const char* to_string(const PacketAccumulator::Error error) {
@@ -173,6 +310,8 @@ inline const char* to_string(const PacketAccumulator::Error error) {
     return "IncorrectCrcCharacter";
   case PacketAccumulator::Error::CrcMismatch:
     return "CrcMismatch";
+  case PacketAccumulator::Error::NoFreeBuffer:
+    return "NoFreeBuffer";
   }
 
   // unreachable
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "packet_accumulator.h"
+#include "spsc_ring.h"
+#include "util.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+namespace arduino_dsmr_2 {
+
+// Moves the work out of the UART interrupt. The data flows through three contexts:
+//   1. The UART interrupt calls `push` with the received bytes. It only copies them into a lock-free ring.
+//   2. The parser task calls `process`. It drains the ring in batches into a PacketAccumulator that rotates between the packet buffers.
+//      A complete packet is handed to the consumer by pushing the index of its buffer into a second ring; the accumulator continues with a free buffer.
+//   3. The consumer calls `acquire_packet`, reads the packet in place and gives the buffer back with `release_packet`.
+// The packet bytes are never copied after the accumulator received them. Every function is meant to be called from one context only.
+// If the consumer holds all the other buffers when a packet is complete, the packet is dropped and its buffer is reused.
+// Usage example:
+//   PacketPipeline<1024, 3, 2048> pipeline(true); // a global variable, so the buffers don't take space on the stack
+//   void IRAM_ATTR on_uart_rx(const char* bytes, size_t size) { pipeline.push({bytes, size}); }
+//   void parser_task(void*) { for (;;) { pipeline.process([](PacketAccumulator::Error error) { ... }); vTaskDelay(1); } }
+//   void consumer_task(void*) {
+//     for (;;) {
+//       if (const auto packet = pipeline.acquire_packet()) {
+//         P1Parser::parse(&data, packet->data.data(), packet->data.size(), false, false);
+//         pipeline.release_packet(*packet);
+//       }
+//       vTaskDelay(1);
+//     }
+//   }
+template <std::size_t ByteRingCapacity, std::size_t NumberOfBuffers, std::size_t BufferSize>
+class PacketPipeline : NonCopyableAndNonMovable {
+  static_assert(NumberOfBuffers >= 2, "One buffer is filled by the accumulator while the consumer holds another one");
+  static_assert(NumberOfBuffers <= 64, "PacketAccumulator rotates between up to 64 buffers");
+
+  struct PacketRef {
+    std::size_t buffer_index;
+    std::size_t size;
+  };
+
+  std::array<std::array<char, BufferSize>, NumberOfBuffers> _buffers{};
+  std::array<std::span<char>, NumberOfBuffers> _buffer_spans = std::apply([](auto&... buffers) { return std::array{std::span<char>(buffers)...}; }, _buffers);
+  SpscRing<char, ByteRingCapacity> _bytes;                                 // interrupt -> parser task
+  SpscRing<PacketRef, std::bit_ceil(NumberOfBuffers)> _packets;            // parser task -> consumer
+  SpscRing<std::size_t, std::bit_ceil(NumberOfBuffers)> _released_buffers; // consumer -> parser task
+  PacketAccumulator _accumulator;
+  std::atomic<std::uint32_t> _dropped_bytes{0};
+  std::atomic<std::uint32_t> _dropped_packets{0};
+
+public:
+  // A complete packet. It stays valid until it is released.
+  struct Packet {
+    std::size_t buffer_index;
+    std::string_view data;
+  };
+
+  explicit PacketPipeline(bool check_crc) : _accumulator(PacketAccumulator::rotating(_buffer_spans, check_crc)) {}
+
+  // Interrupt side. Returns false if the byte ring is full; the bytes that didn't fit are dropped and counted.
+  bool push(std::span<const char> bytes) {
+    const auto pushed = _bytes.push(bytes);
+    if (pushed == bytes.size())
+      return true;
+    _dropped_bytes.fetch_add(static_cast<std::uint32_t>(bytes.size() - pushed), std::memory_order_relaxed);
+    return false;
+  }
+
+  // Parser task side. Drains the byte ring and publishes the complete packets.
+  // `on_error` is called with every PacketAccumulator error, including NoFreeBuffer for the dropped packets.
+  template <typename OnError>
+  void process(OnError&& on_error) {
+    while (const auto buffer_index = _released_buffers.pop())
+      _accumulator.release_packet(std::string_view(_buffers[*buffer_index].data(), 0));
+
+    std::array<char, 64> batch;
+    while (const auto size = _bytes.pop(batch)) {
+      _accumulator.process(std::span(batch).first(size), [&](const PacketAccumulator::Result& res) {
+        if (res.error() == PacketAccumulator::Error::NoFreeBuffer)
+          _dropped_packets.fetch_add(1, std::memory_order_relaxed);
+        if (res.error())
+          on_error(*res.error());
+        if (res.packet()) {
+          // There are fewer packets in flight than buffers, and the ring has room for all the buffers
+          [[maybe_unused]] const bool pushed = _packets.push({buffer_index(*res.packet()), res.packet()->size()});
+          assert(pushed);
+        }
+      });
+    }
+  }
+
+  void process() { process([](PacketAccumulator::Error) {}); }
+
+  // Consumer side. Returns the oldest complete packet that wasn't acquired yet.
+  std::optional<Packet> acquire_packet() {
+    const auto ref = _packets.pop();
+    if (!ref)
+      return {};
+    return Packet{ref->buffer_index, std::string_view(_buffers[ref->buffer_index].data(), ref->size)};
+  }
+
+  // Consumer side. Gives the buffer of an acquired packet back to the parser task. The packet must not be used afterwards.
+  void release_packet(const Packet& packet) { _released_buffers.push(packet.buffer_index); }
+
+  // The number of bytes that didn't fit into the byte ring. The parser task didn't keep up with the UART.
+  std::uint32_t dropped_bytes() const { return _dropped_bytes.load(std::memory_order_relaxed); }
+
+  // The number of complete packets that were dropped because the consumer held all the buffers.
+  std::uint32_t dropped_packets() const { return _dropped_packets.load(std::memory_order_relaxed); }
+
+private:
+  std::size_t buffer_index(const std::string_view packet) const {
+    // The accumulator only returns packets that are in one of the buffers
+    std::size_t i = 0;
+    while (i < NumberOfBuffers && _buffers[i].data() != packet.data())
+      ++i;
+    assert(i < NumberOfBuffers);
+    return i;
+  }
+};
+
+}
@@ -1,22 +1,17 @@
 #pragma once
 
+#include "crc16.h"
+#include "line_splitter.h"
+#include "memory_instrumentation.h"
+#include "timing_stats.h"
 #include "util.h"
+#include <bit>
+#include <cctype>
+#include <span>
+#include <string_view>
 
 namespace arduino_dsmr_2 {
 
-// uses polynomial x^16+x^15+x^2+1
-inline uint16_t crc16_update(uint16_t crc, uint8_t data) {
-  crc ^= data;
-  for (size_t i = 0; i < 8; ++i) {
-    if (crc & 1) {
-      crc = (crc >> 1) ^ 0xA001;
-    } else {
-      crc = (crc >> 1);
-    }
-  }
-  return crc;
-}
-
 // ParsedData is a template for the result of parsing a Dsmr P1 message.
 // You pass the fields you want to add to it as template arguments.
 //
@@ -42,24 +37,58 @@ inline uint16_t crc16_update(uint16_t crc, uint8_t data) {
 template <typename... Ts>
 struct ParsedData : Ts... {
   ParseResult<void> parse_line(const ObisId& obisId, const char* str, const char* end) {
-    ParseResult<void> res;
-    const auto& try_one = [&](auto& field) -> bool {
-      using FieldType = std::decay_t<decltype(field)>;
-      if (obisId != FieldType::id) {
-        return false;
-      }
+    const auto index = field_index(obisId);
+    if (index == sizeof...(Ts))
+      return ParseResult<void>().until(str);
 
-      if (field.present())
-        res = ParseResult<void>().fail("Duplicate field", str);
-      else {
-        field.present() = true;
-        res = field.parse(str, end);
-      }
-      return true;
-    };
+    return parse_field_at(index, str, end);
+  }
+
+  // The index in Ts of the field with the id, or sizeof...(Ts) if none of the fields has it.
+  // The ids of all fields are sorted at compile time, so the field is found with a binary search
+  // instead of comparing the id with every field.
+  static size_t field_index(const ObisId& obisId) {
+    static constexpr auto dispatch_table = make_dispatch_table();
+
+    const uint64_t key = obisId.packed();
+    const auto& keys = dispatch_table.keys;
+    const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key)
+      return sizeof...(Ts);
+
+    return dispatch_table.indexes[static_cast<size_t>(it - keys.begin())];
+  }
 
-    const bool found = (try_one(static_cast<Ts&>(*this)) || ...);
-    return found ? res : ParseResult<void>().until(str);
+  // Parses the value of the field with the index in Ts
+  ParseResult<void> parse_field_at(const size_t index, const char* str, const char* end) {
+    static constexpr std::array<FieldParser, sizeof...(Ts)> parsers{&parse_field<Ts>...};
+    return parsers[index](*this, str, end);
+  }
+
+  using FieldParser = ParseResult<void> (*)(ParsedData&, const char*, const char*);
+
+  struct FoundField {
+    FieldParser parse = nullptr; // nullptr if the line belongs to none of the fields
+    const char* value = nullptr; // the end of the id
+  };
+
+  // Used by P1Parser::parse_selected. Finds the field by the id at the start of the line without parsing the id:
+  // the text of the ids of all fields (e.g. "1-0:1.8.1") is generated at compile time, and the id of the line is compared with them as text.
+  // A line of a field that isn't in Ts is skipped after a few byte comparisons.
+  static FoundField find_field(const char* line, const char* end) {
+    static constexpr auto id_table = make_id_table();
+
+    const char* id_end = line;
+    while (id_end < end && id_end - line < max_id_length && is_id_symbol(*id_end))
+      ++id_end;
+    const auto id = std::string_view(line, static_cast<size_t>(id_end - line));
+    if (id.empty())
+      return {};
+
+    const auto it = std::lower_bound(id_table.begin(), id_table.end(), id, [](const IdText& entry, std::string_view key) { return entry.view() < key; });
+    if (it == id_table.end() || it->view() != id)
+      return {};
+    return {it->parser, id_end};
   }
 
   template <typename F>
@@ -68,11 +97,97 @@ struct ParsedData : Ts... {
   }
 
   bool all_present() { return (Ts::present() && ...); }
+
+  // The memory used by every field, in the order of Ts. Fields that store a std::string can use additional memory on the heap.
+  static constexpr std::array<FieldFootprint, sizeof...(Ts)> field_footprints() { return {FieldFootprint{Ts::name, sizeof(Ts)}...}; }
+
+#if DSMR_TIMING_STATS
+  // The parse time of every field, in the order of Ts. The statistics are shared by all ParsedData types that contain the field.
+  static std::array<FieldTiming, sizeof...(Ts)> field_timings() { return {FieldTiming{Ts::name, &field_timing_stats<Ts>()}...}; }
+#endif
+
+private:
+  template <typename Field>
+  static ParseResult<void> parse_field(ParsedData& data, const char* str, const char* end) {
+    Field& field = data;
+    if (field.present())
+      return ParseResult<void>().fail("Duplicate field", str);
+
+    field.present() = true;
+    [[maybe_unused]] const timing::FieldTimer<Field> timer;
+    return field.parse(str, end);
+  }
+
+  struct DispatchTable {
+    std::array<uint64_t, sizeof...(Ts)> keys;
+    std::array<size_t, sizeof...(Ts)> indexes;
+  };
+
+  static constexpr DispatchTable make_dispatch_table() {
+    DispatchTable table{{Ts::id.packed()...}, {}};
+    for (size_t i = 0; i < sizeof...(Ts); ++i)
+      table.indexes[i] = i;
+
+    // Insertion sort is stable, so if several fields have the same id, the first one in Ts wins.
+    for (size_t i = 1; i < sizeof...(Ts); ++i) {
+      for (size_t j = i; j > 0 && table.keys[j - 1] > table.keys[j]; --j) {
+        std::swap(table.keys[j - 1], table.keys[j]);
+        std::swap(table.indexes[j - 1], table.indexes[j]);
+      }
+    }
+    return table;
+  }
+
+  // "255-255:255.255.255.255"
+  static constexpr std::ptrdiff_t max_id_length = 23;
+
+  static constexpr bool is_id_symbol(const char c) { return (c >= '0' && c <= '9') || c == '-' || c == ':' || c == '.'; }
+
+  struct IdText {
+    std::array<char, max_id_length> text{};
+    size_t size = 0;
+    FieldParser parser = nullptr;
+
+    constexpr std::string_view view() const { return std::string_view(text.data(), size); }
+  };
+
+  // The ids written the way ObisIdParser reads them: "a-b:c.d.e.f" without the trailing parts that are 255.
+  // The identification line (all parts are 255) has no text, so it never matches.
+  static constexpr std::array<IdText, sizeof...(Ts)> make_id_table() {
+    std::array<IdText, sizeof...(Ts)> table{IdText{{}, 0, &parse_field<Ts>}...};
+    const std::array<ObisId, sizeof...(Ts)> ids{Ts::id...};
+
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      size_t parts = 6;
+      while (parts > 0 && ids[i].v[parts - 1] == 255)
+        --parts;
+
+      auto& entry = table[i];
+      for (size_t part = 0; part < parts; ++part) {
+        if (part > 0)
+          entry.text[entry.size++] = part == 1 ? '-' : part == 2 ? ':' : '.';
+        const auto value = ids[i].v[part];
+        if (value >= 100)
+          entry.text[entry.size++] = static_cast<char>('0' + value / 100);
+        if (value >= 10)
+          entry.text[entry.size++] = static_cast<char>('0' + value / 10 % 10);
+        entry.text[entry.size++] = static_cast<char>('0' + value % 10);
+      }
+    }
+
+    // Insertion sort is stable, so if several fields have the same id, the first one in Ts wins, like in parse_line.
+    for (size_t i = 1; i < sizeof...(Ts); ++i) {
+      for (size_t j = i; j > 0 && table[j - 1].view() > table[j].view(); --j)
+        std::swap(table[j - 1], table[j]);
+    }
+    return table;
+  }
 };
 
 struct StringParser {
-  static ParseResult<std::string> parse_string(size_t min, size_t max, const char* str, const char* end) {
-    ParseResult<std::string> res;
+  // Returns the string between the brackets. The result points into the parsed data, nothing is copied.
+  static ParseResult<std::string_view> parse_string(size_t min, size_t max, const char* str, const char* end) {
+    ParseResult<std::string_view> res;
     if (str >= end || *str != '(')
       return res.fail("Missing (", str);
 
@@ -89,15 +204,71 @@ struct StringParser {
     if (len < min || len > max)
       return res.fail("Invalid string length", str_start);
 
-    res.result.append(str_start, len);
+    res.result = std::string_view(str_start, len);
 
     return res.until(str_end + 1); // Skip )
   }
 };
 
+// Converts the YYMMDDhhmmssX text of a timestamp into a Timestamp without allocating memory.
+// The timestamps of a telegram (the time of the telegram, the readings of the M-Bus meters, the maximum demand of the month)
+// usually have the same date. The date of the last timestamp parsed on the thread is cached, so such a date is converted once.
+struct TimestampParser {
+  // Returns Timestamp::invalid() if the text isn't a valid date and time
+  static Timestamp parse(const std::string_view text) {
+    if (text.size() != 13 || (text[12] != 'S' && text[12] != 'W'))
+      return Timestamp::invalid();
+
+    std::array<uint32_t, 6> parts;
+    for (size_t i = 0; i < 6; ++i) {
+      const auto high = static_cast<uint32_t>(text[i * 2] - '0');
+      const auto low = static_cast<uint32_t>(text[i * 2 + 1] - '0');
+      if (high > 9 || low > 9)
+        return Timestamp::invalid();
+      parts[i] = high * 10 + low;
+    }
+    if (parts[3] > 23 || parts[4] > 59 || parts[5] > 59)
+      return Timestamp::invalid();
+
+    const auto days = days_of_date(text.substr(0, 6), parts[0], parts[1], parts[2]);
+    if (days == Timestamp::invalid_seconds)
+      return Timestamp::invalid();
+
+    const bool summer_time = text[12] == 'S';
+    const uint32_t local_seconds = days * 86400 + parts[3] * 3600 + parts[4] * 60 + parts[5];
+    if (summer_time && local_seconds < 3600)
+      return Timestamp::invalid();
+    return Timestamp{local_seconds - (summer_time ? 3600 : 0), summer_time};
+  }
+
+private:
+  struct DateCache {
+    std::array<char, 6> date{};
+    uint32_t days = Timestamp::invalid_seconds;
+  };
+
+  // Returns the number of days since 2000-01-01, or Timestamp::invalid_seconds if the date doesn't exist
+  static uint32_t days_of_date(const std::string_view date, const uint32_t year, const uint32_t month, const uint32_t day) {
+    thread_local DateCache cache;
+    if (cache.days != Timestamp::invalid_seconds && std::string_view(cache.date.data(), cache.date.size()) == date)
+      return cache.days;
+
+    static constexpr uint8_t days_in_month[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month[month - 1] || (month == 2 && day == 29 && year % 4 != 0))
+      return Timestamp::invalid_seconds;
+
+    std::copy(date.begin(), date.end(), cache.date.begin());
+    cache.days = Timestamp::days_from_date(2000 + year, month, day);
+    return cache.days;
+  }
+};
+
 static constexpr char INVALID_NUMBER[] = "Invalid number";
 static constexpr char INVALID_UNIT[] = "Invalid unit";
 
+// Values are mostly fixed-width numbers like (000671.578*kWh), so the digits are parsed up to 8 at a time:
+// a run of digits is loaded into a 64-bit word and converted with a few multiplications (SWAR).
+// The integer arithmetic is modulo 2^32, so overflowing numbers give the same result as a digit by digit loop.
 struct NumParser {
   static ParseResult<uint32_t> parse(size_t max_decimals, const char* unit, const char* str, const char* end) {
     ParseResult<uint32_t> res;
@@ -105,36 +276,28 @@ struct NumParser {
       return res.fail("Missing (", str);
 
     const char* num_start = str + 1; // Skip (
-    const char* num_end = num_start;
-
     uint32_t value = 0;
 
     // Parse integer part
-    while (num_end < end && !strchr("*.)", *num_end)) {
-      if (*num_end < '0' || *num_end > '9')
-        return res.fail(INVALID_NUMBER, num_end);
-      value *= 10;
-      value += static_cast<uint32_t>(*num_end - '0');
-      ++num_end;
-    }
+    const char* num_end = parse_digits(num_start, end, SIZE_MAX, value);
+    if (num_end < end && !is_one_of(*num_end, "*.)"))
+      return res.fail(INVALID_NUMBER, num_end);
 
     // Parse decimal part, if any
     if (max_decimals && num_end < end && *num_end == '.') {
       ++num_end;
 
-      while (num_end < end && !strchr("*)", *num_end) && max_decimals) {
-        max_decimals--;
-        if (*num_end < '0' || *num_end > '9')
-          return res.fail(INVALID_NUMBER, num_end);
-        value *= 10;
-        value += static_cast<uint32_t>(*num_end - '0');
-        ++num_end;
-      }
+      const char* decimals_end = parse_digits(num_end, end, max_decimals, value);
+      max_decimals -= static_cast<size_t>(decimals_end - num_end);
+      num_end = decimals_end;
+      if (max_decimals && num_end < end && !is_one_of(*num_end, "*)"))
+        return res.fail(INVALID_NUMBER, num_end);
     }
 
     // Fill in missing decimals with zeroes
-    while (max_decimals--)
+    for (; max_decimals >= pow10.size(); max_decimals--)
       value *= 10;
+    value *= pow10[max_decimals];
 
     // Workaround for https://github.com/matthijskooijman/arduino-dsmr/issues/50
     // If value is 0, then we allow missing unit.
@@ -148,6 +311,10 @@ struct NumParser {
       if (num_end >= end || *num_end != '*')
         return res.fail("Missing unit", num_end);
       const char* unit_start = ++num_end; // skip *
+      if (const char* unit_end = match_unit(unit, str, unit_start, end))
+        return res.succeed(value).until(unit_end);
+
+      // Slow path, finds the exact error
       while (num_end < end && *num_end != ')' && *unit) {
         // Next character in units do not match?
         if (std::tolower(static_cast<unsigned char>(*num_end++)) != std::tolower(static_cast<unsigned char>(*unit++)))
@@ -163,6 +330,107 @@ struct NumParser {
 
     return res.succeed(value).until(num_end + 1); // Skip )
   }
+
+private:
+  static constexpr std::array<uint32_t, 10> pow10 = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+  // Same as strchr(chars, c) != nullptr, including the match of the terminating '\0', but without a function call
+  template <size_t N>
+  static bool is_one_of(const char c, const char (&chars)[N]) {
+    return std::find(chars, chars + N, c) != chars + N;
+  }
+
+  static uint64_t load_word(const char* str) {
+    uint64_t word;
+    std::memcpy(&word, str, sizeof(word));
+    return word;
+  }
+
+  // Number of digits at the start of the word. A byte >= 0xFA can carry into the next byte,
+  // but it is not a digit itself, so the count of the leading digits is still exact.
+  static size_t leading_digits(const uint64_t word) {
+    const uint64_t non_digits = ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^ 0x3333333333333333;
+    return static_cast<size_t>(std::countr_zero(non_digits)) / 8;
+  }
+
+  // Converts 8 digits, the first digit is in the lowest byte
+  static uint32_t convert_8_digits(uint64_t word) {
+    word -= 0x3030303030303030;
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((word >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<uint32_t>(word);
+  }
+
+  // Appends up to max_digits digits to value and returns the position of the first unparsed character.
+  // 32-bit microcontrollers don't have 64-bit multiplications, so they only use the digit by digit loop.
+  static const char* parse_digits(const char* str, const char* end, size_t max_digits, uint32_t& value) {
+    if constexpr (std::endian::native == std::endian::little && sizeof(size_t) >= sizeof(uint64_t)) {
+      while (end - str >= 8 && max_digits) {
+        const uint64_t word = load_word(str);
+        const size_t digits = std::min(leading_digits(word), max_digits);
+        if (digits == 0)
+          return str;
+
+        // Move the digits to the end of the word and pad the start with '0'
+        const uint64_t padded = digits == 8 ? word : (word << (8 * (8 - digits))) | (0x3030303030303030 >> (8 * digits));
+        value = value * pow10[digits] + convert_8_digits(padded);
+        str += digits;
+        max_digits -= digits;
+        if (digits < 8)
+          return str;
+      }
+    }
+
+    for (; str < end && max_digits && *str >= '0' && *str <= '9'; ++str, --max_digits)
+      value = value * 10 + static_cast<uint32_t>(*str - '0');
+    return str;
+  }
+
+  // Compares the unit in the message with the expected unit and the closing ')' in a single word comparison.
+  // Letters may differ in case: the 0x20 bit is ignored for them.
+  // Returns the position after ')' or nullptr if the unit doesn't match or is too long for one word.
+  // [begin, str) is the already parsed part of the value, which can be read as well.
+  static const char* match_unit(const char* unit, const char* begin, const char* str, const char* end) {
+    // The words are built with shifts: storing single bytes and loading them as a word stalls the store forwarding
+    const auto& byte_at = [](const size_t i, const uint64_t byte) {
+      return byte << (std::endian::native == std::endian::little ? 8 * i : 8 * (7 - i));
+    };
+
+    uint64_t expected = 0;
+    uint64_t case_bits = 0;
+    uint64_t compared_bytes = 0;
+    size_t len = 0;
+    for (; unit[len]; ++len) {
+      if (len == 7)
+        return nullptr;
+      const auto c = static_cast<uint8_t>(unit[len]);
+      expected |= byte_at(len, c);
+      if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+        case_bits |= byte_at(len, 0x20);
+      compared_bytes |= byte_at(len, 0xFF);
+    }
+    expected |= byte_at(len, ')');
+    compared_bytes |= byte_at(len, 0xFF);
+
+    if (end - str <= static_cast<std::ptrdiff_t>(len))
+      return nullptr;
+
+    // The unit is usually at the end of the line. Then the word is loaded so that it ends at the end of the line
+    // and the bytes before the unit (the number) are shifted out.
+    uint64_t actual;
+    if (end - str >= 8) {
+      actual = load_word(str);
+    } else if (end - begin >= 8) {
+      const auto& skipped = 8 * static_cast<size_t>(8 - (end - str));
+      actual = std::endian::native == std::endian::little ? load_word(end - 8) >> skipped : load_word(end - 8) << skipped;
+    } else {
+      char tail[8] = {};
+      std::memcpy(tail, str, static_cast<size_t>(end - str));
+      actual = load_word(tail);
+    }
+
+    return ((actual ^ expected) & ~case_bits & compared_bytes) == 0 ? str + len + 1 : nullptr;
+  }
 };
 
 struct ObisIdParser {
@@ -252,8 +520,115 @@ struct P1Parser {
   // with '/' and run up to and including the ! and the following
   // four byte checksum. It's ok if the string is longer, the .next
   // pointer in the result will indicate the next unprocessed byte.
+  // Data is a ParsedData or another type with the same parse_line method, like a row of ColumnarData.
+  template <typename Data>
+  static ParseResult<void> parse(Data* data, const char* str, size_t n, bool unknown_error = false, bool check_crc = true) {
+    return parse_telegram(str, n, check_crc,
+                          [&](const char* data_begin, const char* data_end) { return parse_data(data, data_begin, data_end, unknown_error); });
+  }
+
+  // A faster version of `parse` for a ParsedData with a few fields. The CRC is checked the same way, but:
+  //   - the lines of the fields that aren't in Ts are skipped after comparing the first bytes of the id (see ParsedData::find_field).
+  //     Such lines are not checked, so there is no "Unknown field" error. The id has to be written without leading zeros, as all meters do.
+  //   - parsing stops as soon as all fields are present, so duplicate fields after that point are not reported.
+  template <typename... Ts>
+  static ParseResult<void> parse_selected(ParsedData<Ts...>* data, const char* str, size_t n, bool check_crc = true) {
+    return parse_telegram(str, n, check_crc, [&](const char* data_begin, const char* data_end) { return parse_selected_data(data, data_begin, data_end); });
+  }
+
+  // Parses many complete telegrams one after another, for example an archive of raw telegrams.
+  // The i-th telegram is parsed into outputs[i] and its result is stored in results[i]. Only as many telegrams are parsed as there are outputs and results.
+  // Every output is reset before parsing, so the same outputs can be used for the next batch.
+  // Returns the number of telegrams without errors. BatchParser (batch_parser.h) does the same on several threads.
   template <typename... Ts>
-  static ParseResult<void> parse(ParsedData<Ts...>* data, const char* str, size_t n, bool unknown_error = false, bool check_crc = true) {
+  static size_t parse_batch(std::span<const std::string_view> telegrams, std::span<ParsedData<Ts...>> outputs, std::span<ParseResult<void>> results,
+                            bool unknown_error = false, bool check_crc = true) {
+    const auto count = std::min({telegrams.size(), outputs.size(), results.size()});
+    size_t parsed = 0;
+    for (size_t i = 0; i < count; ++i) {
+      outputs[i] = ParsedData<Ts...>();
+      results[i] = parse(&outputs[i], telegrams[i].data(), telegrams[i].size(), unknown_error, check_crc);
+      if (!results[i].err)
+        ++parsed;
+    }
+    return parsed;
+  }
+
+  // Parse the data part of a message. Str should point to the first
+  // character after the leading /, end should point to the ! before the
+  // checksum. Does not verify the checksum.
+  template <typename Data>
+  static ParseResult<void> parse_data(Data* data, const char* str, const char* end, bool unknown_error = false) {
+    const auto id_line = parse_identification_line(data, str, end);
+    if (id_line.err)
+      return id_line;
+
+    // Parse data lines
+    return split_logical_lines(id_line.next, end, [&](const char* first, const char* last) { return parse_line(data, first, last, unknown_error); });
+  }
+
+  // The same as parse_data, but for parse_selected
+  template <typename... Ts>
+  static ParseResult<void> parse_selected_data(ParsedData<Ts...>* data, const char* str, const char* end) {
+    const auto id_line = parse_identification_line(data, str, end);
+    if (id_line.err)
+      return id_line;
+
+    const char* line = id_line.next;
+    while (line < end && !data->all_present()) {
+      // A value can continue on the next physical lines (e.g. a long message or a gas reading on a separate line),
+      // so the other lines are skipped by the same rules as parse uses to split them
+      const auto line_end = find_logical_line_end(line, end);
+      if (line_end.err)
+        return line_end;
+
+      const auto field = ParsedData<Ts...>::find_field(line, line_end.next);
+      if (!field.parse) {
+        line = line_end.next + 1;
+        continue;
+      }
+
+      const auto res = field.parse(*data, field.value, line_end.next);
+      if (res.err)
+        return res;
+      if (res.next != line_end.next)
+        return ParseResult<void>().fail("Trailing characters on data line", res.next);
+      line = line_end.next + 1;
+    }
+    return ParseResult<void>();
+  }
+
+  template <typename Data>
+  static ParseResult<void> parse_line(Data* data, const char* line, const char* end, bool unknown_error) {
+    ParseResult<void> res;
+    if (line == end)
+      return res;
+
+    ParseResult<ObisId> idres = ObisIdParser::parse(line, end);
+    if (idres.err)
+      return idres;
+
+    ParseResult<void> datares = data->parse_line(idres.result, idres.next, end);
+    if (datares.err)
+      return datares;
+
+    // If datares.next didn't move at all, there was no parser for
+    // this field, that's ok. But if it did move, but not all the way
+    // to the end, that's an error.
+    if (datares.next != idres.next && datares.next != end)
+      return res.fail("Trailing characters on data line", datares.next);
+    else if (datares.next == idres.next && unknown_error)
+      return res.fail("Unknown field", line);
+
+    return res.until(end);
+  }
+
+private:
+  // Checks the framing and the CRC of a telegram and calls parse_data_part(data_begin, data_end) for the payload between '/' and '!'
+  template <typename ParseDataPart>
+  static ParseResult<void> parse_telegram(const char* str, size_t n, bool check_crc, ParseDataPart&& parse_data_part) {
+    [[maybe_unused]] const memory_instrumentation::ParseScope memory_scope;
+    [[maybe_unused]] const timing::TelegramTimer telegram_timer;
     ParseResult<void> res;
 
     const char* const buf_begin = str;
@@ -276,9 +651,7 @@ struct P1Parser {
         return res.fail("No checksum found", term);
 
       // Compute CRC over '/' .. '!' (inclusive).
-      uint16_t crc = 0;
-      for (const char* p = buf_begin; p <= term; ++p)
-        crc = crc16_update(crc, static_cast<uint8_t>(*p));
+      const uint16_t crc = timing::measure(&TimingStats::crc_time, [&] { return Crc16::update(0, buf_begin, static_cast<size_t>(term + 1 - buf_begin)); });
 
       // Parse and verify the 4-hex checksum after '!'
       ParseResult<uint16_t> check = CrcParser::parse(term + 1, buf_end);
@@ -288,28 +661,21 @@ struct P1Parser {
         return res.fail("Checksum mismatch", term + 1);
 
       // Parse payload (between '/' and '!')
-      res = parse_data(data, data_begin, term, unknown_error);
+      res = parse_data_part(data_begin, term);
       res.next = check.next; // Advance past checksum
       return res;
     }
 
     // No CRC checking: parse up to '!' if present, otherwise up to buf_end.
-    res = parse_data(data, data_begin, term, unknown_error);
+    res = parse_data_part(data_begin, term);
     res.next = (term < buf_end) ? term : buf_end;
     return res;
   }
 
-  // Parse the data part of a message. Str should point to the first
-  // character after the leading /, end should point to the ! before the
-  // checksum. Does not verify the checksum.
-  template <typename... Ts>
-  static ParseResult<void> parse_data(ParsedData<Ts...>* data, const char* str, const char* end, bool unknown_error = false) {
-    // Split into lines and parse those
-    const char* line_end = str;
-    const char* line_start = str;
-
-    // Parse ID line
-    while (line_end < end) {
+  // Parses the identification line. On success, `next` points to the first data line.
+  template <typename Data>
+  static ParseResult<void> parse_identification_line(Data* data, const char* str, const char* end) {
+    for (const char* line_end = str; line_end < end; ++line_end) {
       if (*line_end == '\r' || *line_end == '\n') {
         // The first identification line looks like:
         // XXX5<id string>
@@ -327,84 +693,17 @@ struct P1Parser {
         //
         // Offer it for processing using the all-ones Obis ID, which
         // is not otherwise valid.
-        ParseResult<void> tmp = data->parse_line(ObisId(255, 255, 255, 255, 255, 255), line_start, line_end);
+        ParseResult<void> tmp = data->parse_line(ObisId(255, 255, 255, 255, 255, 255), str, line_end);
         if (tmp.err)
           return tmp;
-        line_start = ++line_end;
-        break;
-      }
-      ++line_end;
-    }
-
-    // Parse data lines
-    // We need to track brackets to handle cases like:
-    //   0-0:96.13.0(303132333435
-    //   30313233343)
-    bool open_bracket_found = false;
-    while (line_end < end) {
-      char c = *line_end;
-
-      if (c == '(') {
-        if (open_bracket_found) {
-          return ParseResult<void>().fail("Unexpected '(' symbol", line_end);
-        }
-        open_bracket_found = true;
-      } else if (c == ')') {
-        if (!open_bracket_found) {
-          return ParseResult<void>().fail("Unexpected ')' symbol", line_end);
-        }
-        open_bracket_found = false;
-      } else if (c == '\r' || c == '\n') {
-
-        // handles case like:
-        //  0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)
-        //  (00124.477)
-        const auto& next_part_of_the_data_line_on_next_line = (end - line_end > 2) && (line_end[1] == '(' || line_end[2] == '(');
-
-        const auto& break_in_the_middle_of_the_data_line = open_bracket_found || next_part_of_the_data_line_on_next_line;
-
-        if (!break_in_the_middle_of_the_data_line) {
-          // End of logical line -> parse it
-          ParseResult<void> tmp = parse_line(data, line_start, line_end, unknown_error);
-          if (tmp.err)
-            return tmp;
-
-          line_start = line_end + 1;
-        }
+        return ParseResult<void>().until(line_end + 1);
       }
-
-      ++line_end;
     }
 
-    if (line_end != line_start)
-      return ParseResult<void>().fail("Last dataline not CRLF terminated", line_end);
-
-    return ParseResult<void>();
-  }
-
-  template <typename Data>
-  static ParseResult<void> parse_line(Data* data, const char* line, const char* end, bool unknown_error) {
-    ParseResult<void> res;
-    if (line == end)
-      return res;
-
-    ParseResult<ObisId> idres = ObisIdParser::parse(line, end);
-    if (idres.err)
-      return idres;
-
-    ParseResult<void> datares = data->parse_line(idres.result, idres.next, end);
-    if (datares.err)
-      return datares;
-
-    // If datares.next didn't move at all, there was no parser for
-    // this field, that's ok. But if it did move, but not all the way
-    // to the end, that's an error.
-    if (datares.next != idres.next && datares.next != end)
-      return res.fail("Trailing characters on data line", datares.next);
-    else if (datares.next == idres.next && unknown_error)
-      return res.fail("Unknown field", line);
-
-    return res.until(end);
+    // No line break: like a data line without one
+    if (str != end)
+      return ParseResult<void>().fail("Last dataline not CRLF terminated", end);
+    return ParseResult<void>().until(end);
   }
 };
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace arduino_dsmr_2 {
+
+// A lock-free ring buffer for exactly one producer and one consumer, for example a UART interrupt and a FreeRTOS task.
+// Neither side ever blocks or disables interrupts: the producer only writes the head index and the consumer only writes the tail index.
+// The indexes grow without wrapping around the capacity, so a full ring is distinguished from an empty one without wasting a slot.
+// Capacity must be a power of two.
+template <typename T, std::size_t Capacity>
+class SpscRing : NonCopyableAndNonMovable {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+  static_assert(std::atomic<std::size_t>::is_always_lock_free, "The indexes must be lock-free to be used from an interrupt");
+
+  // The indexes are on separate cache lines, so the producer and the consumer don't invalidate each other's cache
+  alignas(64) std::atomic<std::size_t> _head{0}; // the next slot to write, written by the producer
+  alignas(64) std::atomic<std::size_t> _tail{0}; // the next slot to read, written by the consumer
+  std::array<T, Capacity> _items{};
+
+public:
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  // Producer side. Returns false if the ring is full.
+  bool push(const T& item) {
+    const auto head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == Capacity)
+      return false;
+
+    _items[head % Capacity] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer side. Pushes as many items as fit and returns their number.
+  std::size_t push(std::span<const T> items) {
+    const auto head = _head.load(std::memory_order_relaxed);
+    const auto count = std::min(items.size(), Capacity - (head - _tail.load(std::memory_order_acquire)));
+
+    for (std::size_t i = 0; i < count; ++i)
+      _items[(head + i) % Capacity] = items[i];
+    _head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer side. Returns an empty optional if the ring is empty.
+  std::optional<T> pop() {
+    const auto tail = _tail.load(std::memory_order_relaxed);
+    if (_head.load(std::memory_order_acquire) == tail)
+      return {};
+
+    std::optional<T> item(std::move(_items[tail % Capacity]));
+    _tail.store(tail + 1, std::memory_order_release);
+    return item;
+  }
+
+  // Consumer side. Takes as many items as are available and fit into `items` and returns their number.
+  std::size_t pop(std::span<T> items) {
+    const auto tail = _tail.load(std::memory_order_relaxed);
+    const auto count = std::min(items.size(), _head.load(std::memory_order_acquire) - tail);
+
+    for (std::size_t i = 0; i < count; ++i)
+      items[i] = std::move(_items[(tail + i) % Capacity]);
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // The number of items in the ring. It is exact only when called from the producer or the consumer while the other side is idle.
+  std::size_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0; }
+};
+
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "crc16.h"
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+namespace arduino_dsmr_2 {
+
+enum class StreamParserError { LineTooLong, PacketStartSymbolInPacket, IncorrectCrcCharacter, CrcMismatch, ParseError };
+
+inline const char* to_string(const StreamParserError error) {
+  switch (error) {
+  case StreamParserError::LineTooLong:
+    return "LineTooLong";
+  case StreamParserError::PacketStartSymbolInPacket:
+    return "PacketStartSymbolInPacket";
+  case StreamParserError::IncorrectCrcCharacter:
+    return "IncorrectCrcCharacter";
+  case StreamParserError::CrcMismatch:
+    return "CrcMismatch";
+  case StreamParserError::ParseError:
+    return "ParseError";
+  }
+
+  // unreachable
+  return "Unknown error";
+}
+
+// Parses a telegram while it is being received, so the whole telegram is never stored.
+// Every data line is parsed into Data as soon as it is complete, and the CRC is calculated in the same pass.
+// The line buffer only needs to fit the longest line (a value that is split across physical lines counts as one line) instead of the whole telegram.
+// The telegram is reported the moment the last CRC symbol arrives.
+//
+// The lines are split the same way as in P1Parser::parse, including the values that are split across lines and the values that continue on
+// the next line with '('. Like with PacketAccumulator + P1Parser::parse, errors of a telegram are reported after its CRC check,
+// so a corrupted telegram is reported as CrcMismatch and not as the parse error that the corruption caused.
+//
+// Note: the fields are filled while the telegram arrives, so data() only holds a consistent telegram right after it is reported.
+template <typename Data>
+class StreamParser {
+  static_assert(!has_string_view_fields<Data>::value, "The line buffer is overwritten by the next line, so Data can't contain std::string_view fields");
+  enum class State { WaitingForPacketStartSymbol, IdentificationLine, DataLines, WaitingForCrc };
+  State _state = State::WaitingForPacketStartSymbol;
+
+  // The current logical line followed by up to 2 bytes of lookahead that decide if a line break ends the line.
+  // The bytes before _scanned are already checked for brackets and line breaks.
+  std::span<char> _line;
+  std::size_t _size = 0;
+  std::size_t _scanned = 0;
+  bool _open_bracket_found = false;
+
+  uint16_t _crc = 0;
+  char _received_crc[4] = {};
+  std::size_t _received_crc_length = 0;
+
+  // The first error of the telegram. The following lines are not parsed, but the CRC is still checked.
+  std::optional<StreamParserError> _error;
+  const char* _parse_error = nullptr;
+
+  bool _check_crc;
+  bool _unknown_error;
+  Data _data;
+
+public:
+  class Result {
+    friend class StreamParser;
+
+    const Data* _telegram = nullptr;
+    std::optional<StreamParserError> _error;
+    const char* _parse_error = nullptr;
+
+    Result() = default;
+    Result(const Data* telegram) : _telegram(telegram) {}
+    Result(StreamParserError error, const char* parse_error = nullptr) : _error(error), _parse_error(parse_error) {}
+
+  public:
+    // The parsed telegram. It stays valid until the next telegram starts.
+    auto telegram() const { return _telegram; }
+    auto error() const { return _error; }
+    // The error message of P1Parser when the error is ParseError
+    auto parse_error() const { return _parse_error; }
+  };
+
+  StreamParser(std::span<char> line_buffer, bool check_crc, bool unknown_error = false)
+      : _line(line_buffer), _check_crc(check_crc), _unknown_error(unknown_error) {}
+
+  Result process_byte(const char byte) {
+    if (byte == '/') {
+      const bool interrupted = _state != State::WaitingForPacketStartSymbol;
+      start_telegram();
+      if (interrupted)
+        return StreamParserError::PacketStartSymbolInPacket;
+      return {};
+    }
+
+    switch (_state) {
+    case State::WaitingForPacketStartSymbol:
+      return {};
+
+    case State::IdentificationLine:
+    case State::DataLines:
+      _crc = Crc16::update(_crc, static_cast<uint8_t>(byte));
+      if (byte == '!') {
+        end_of_data();
+        if (!_check_crc)
+          return finish_telegram();
+        _state = State::WaitingForCrc;
+        return {};
+      }
+      if (!_error)
+        add_data_byte(byte);
+      return {};
+
+    case State::WaitingForCrc: {
+      _received_crc[_received_crc_length++] = byte;
+      if (_received_crc_length < sizeof(_received_crc))
+        return {};
+
+      const auto received_crc = CrcParser::parse(_received_crc, _received_crc + sizeof(_received_crc));
+      if (received_crc.err) {
+        _state = State::WaitingForPacketStartSymbol;
+        return StreamParserError::IncorrectCrcCharacter;
+      }
+      if (received_crc.result != _crc) {
+        _state = State::WaitingForPacketStartSymbol;
+        return StreamParserError::CrcMismatch;
+      }
+      return finish_telegram();
+    }
+    }
+
+    // unreachable
+    return {};
+  }
+
+  // Feeds a chunk of bytes to the parser. The same as calling `process_byte` for every byte of the chunk.
+  // `on_result` is called with every Result that contains a telegram or an error, in the order they occur.
+  template <typename Callback>
+  void process(std::span<const char> bytes, Callback&& on_result) {
+    for (const char byte : bytes) {
+      const auto res = process_byte(byte);
+      if (res.telegram() || res.error())
+        on_result(res);
+    }
+  }
+
+  // The fields of the last telegram. During the reception of a telegram, it contains the fields that were received so far.
+  const Data& data() const { return _data; }
+
+private:
+  void start_telegram() {
+    _state = State::IdentificationLine;
+    _size = 0;
+    _scanned = 0;
+    _open_bracket_found = false;
+    _crc = Crc16::update(0, static_cast<uint8_t>('/'));
+    _received_crc_length = 0;
+    _error.reset();
+    _parse_error = nullptr;
+    _data = Data();
+  }
+
+  Result finish_telegram() {
+    _state = State::WaitingForPacketStartSymbol;
+    if (_error)
+      return Result(*_error, _parse_error);
+    return Result(&_data);
+  }
+
+  void fail(const StreamParserError error, const char* parse_error = nullptr) {
+    _error = error;
+    _parse_error = parse_error;
+  }
+
+  void add_data_byte(const char byte) {
+    // The identification line ends at the first line break. It is offered for processing using the all-ones Obis ID, like in P1Parser::parse_data
+    if (_state == State::IdentificationLine && (byte == '\r' || byte == '\n')) {
+      const auto res = _data.parse_line(ObisId(255, 255, 255, 255, 255, 255), _line.data(), _line.data() + _size);
+      if (res.err)
+        return fail(StreamParserError::ParseError, res.err);
+      _size = 0;
+      _state = State::DataLines;
+      return;
+    }
+
+    if (_size == _line.size())
+      return fail(StreamParserError::LineTooLong);
+    _line[_size++] = byte;
+
+    if (_state == State::DataLines) {
+      while (!_error && _size - _scanned > 2)
+        scan_byte(/*lookahead_available=*/true);
+    }
+  }
+
+  // The '!' symbol arrived: the remaining line breaks can't be followed by a continuation of the line
+  void end_of_data() {
+    // Without a line break, the identification line is not CRLF terminated, like in P1Parser::parse_data
+    if (_state == State::IdentificationLine) {
+      if (!_error && _size != 0)
+        fail(StreamParserError::ParseError, "Last dataline not CRLF terminated");
+      return;
+    }
+    while (!_error && _scanned < _size)
+      scan_byte(/*lookahead_available=*/false);
+    if (!_error && _size != 0)
+      fail(StreamParserError::ParseError, "Last dataline not CRLF terminated");
+  }
+
+  // The same rules as in split_logical_lines
+  void scan_byte(const bool lookahead_available) {
+    const char* const p = _line.data() + _scanned;
+    switch (*p) {
+    case '(':
+      if (_open_bracket_found)
+        return fail(StreamParserError::ParseError, "Unexpected '(' symbol");
+      _open_bracket_found = true;
+      break;
+    case ')':
+      if (!_open_bracket_found)
+        return fail(StreamParserError::ParseError, "Unexpected ')' symbol");
+      _open_bracket_found = false;
+      break;
+    case '\r':
+    case '\n': {
+      const bool next_part_of_the_data_line_on_next_line = lookahead_available && (p[1] == '(' || p[2] == '(');
+      if (_open_bracket_found || next_part_of_the_data_line_on_next_line)
+        break;
+
+      // End of logical line -> parse it and keep the lookahead for the next line
+      const auto res = P1Parser::parse_line(&_data, _line.data(), p, _unknown_error);
+      if (res.err)
+        return fail(StreamParserError::ParseError, res.err);
+      _size -= _scanned + 1;
+      std::memmove(_line.data(), p + 1, _size);
+      _scanned = 0;
+      return;
+    }
+    }
+    ++_scanned;
+  }
+};
+
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "fields.h"
+#include "parser.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace arduino_dsmr_2 {
+
+// The minimum, maximum and average of the values that were added to it
+struct Aggregate {
+  uint32_t min = 0;
+  uint32_t max = 0;
+  uint64_t sum = 0;
+  uint32_t count = 0;
+
+  bool empty() const { return count == 0; }
+  uint32_t average() const { return count ? static_cast<uint32_t>(sum / count) : 0; }
+
+  void add(const uint32_t value) {
+    min = count ? std::min(min, value) : value;
+    max = count ? std::max(max, value) : value;
+    sum += value;
+    ++count;
+  }
+
+  void merge(const Aggregate& other) {
+    if (other.empty())
+      return;
+    min = count ? std::min(min, other.min) : other.min;
+    max = count ? std::max(max, other.max) : other.max;
+    sum += other.sum;
+    count += other.count;
+  }
+};
+
+// A circular buffer of the aggregates of the last Capacity periods of SecondsPerBucket seconds.
+// The periods are aligned to multiples of SecondsPerBucket, so with the time in Unix seconds, 900-second buckets are the quarter hours of the clock.
+// The aggregate of a period is updated with every value, so the current period can be queried at any time.
+template <size_t Capacity, uint32_t SecondsPerBucket>
+class TimeSeriesBuckets {
+  static_assert(Capacity > 0 && SecondsPerBucket > 0);
+
+  std::array<Aggregate, Capacity> _buckets{};
+  size_t _newest = 0;          // the index of the current period in _buckets
+  uint32_t _newest_period = 0; // the time of the current period divided by SecondsPerBucket
+  bool _started = false;
+
+public:
+  static constexpr size_t capacity() { return Capacity; }
+  static constexpr uint32_t seconds_per_bucket() { return SecondsPerBucket; }
+
+  // Returns false if the time is before the current period. The value is ignored in that case.
+  bool add(const uint32_t time, const uint32_t value) {
+    const auto period = time / SecondsPerBucket;
+    if (!_started) {
+      _started = true;
+      _newest_period = period;
+    } else if (period < _newest_period) {
+      return false;
+    } else if (period - _newest_period >= Capacity) {
+      // Nothing was added for longer than the buffer covers
+      _buckets = {};
+      _newest_period = period;
+    } else {
+      // The periods without values stay empty
+      for (; _newest_period < period; ++_newest_period) {
+        _newest = (_newest + 1) % Capacity;
+        _buckets[_newest] = Aggregate();
+      }
+    }
+    _buckets[_newest].add(value);
+    return true;
+  }
+
+  // The aggregate of the period `age` periods before the current one: bucket(0) is the current period, bucket(1) the previous one.
+  // Periods without values, periods before the first value and periods that don't fit into the buffer (age >= Capacity) are empty.
+  const Aggregate& bucket(const size_t age) const {
+    static constexpr Aggregate empty;
+    if (age >= Capacity)
+      return empty;
+    return _buckets[(_newest + Capacity - age) % Capacity];
+  }
+  const Aggregate& current() const { return bucket(0); }
+
+  // The start time of the period of bucket(age). The periods before time 0 start at 0.
+  uint32_t start_time(const size_t age) const {
+    if (age > _newest_period)
+      return 0;
+    return (_newest_period - static_cast<uint32_t>(age)) * SecondsPerBucket;
+  }
+
+  // The aggregate of the last `count` periods, including the current one. Takes O(count), at most Capacity merges.
+  Aggregate last(const size_t count) const {
+    Aggregate result;
+    for (size_t age = 0; age < std::min(count, Capacity); ++age)
+      result.merge(bucket(age));
+    return result;
+  }
+
+  void clear() {
+    _buckets = {};
+    _newest = 0;
+    _started = false;
+  }
+};
+
+// The number of buckets of every resolution of a TimeSeries
+template <size_t Seconds, size_t Minutes, size_t QuarterHours>
+struct TimeSeriesCapacity {
+  static constexpr size_t seconds = Seconds;
+  static constexpr size_t minutes = Minutes;
+  static constexpr size_t quarter_hours = QuarterHours;
+};
+
+// The last minute by second, the last hour by minute and the last day by quarter hour. Takes 5 KB per field.
+using DefaultTimeSeriesCapacity = TimeSeriesCapacity<60, 60, 96>;
+
+// The history of one field at the 3 resolutions of a TimeSeries
+template <typename Capacity>
+class FieldTimeSeries {
+  TimeSeriesBuckets<Capacity::seconds, 1> _seconds;
+  TimeSeriesBuckets<Capacity::minutes, 60> _minutes;
+  TimeSeriesBuckets<Capacity::quarter_hours, 15 * 60> _quarter_hours;
+
+public:
+  const TimeSeriesBuckets<Capacity::seconds, 1>& seconds() const { return _seconds; }
+  const TimeSeriesBuckets<Capacity::minutes, 60>& minutes() const { return _minutes; }
+  const TimeSeriesBuckets<Capacity::quarter_hours, 15 * 60>& quarter_hours() const { return _quarter_hours; }
+
+  bool add(const uint32_t time, const uint32_t value) {
+    // The resolutions can't disagree: the periods of a finer resolution are inside the periods of a coarser one
+    if (!_seconds.add(time, value))
+      return false;
+    _minutes.add(time, value);
+    _quarter_hours.add(time, value);
+    return true;
+  }
+
+  void clear() {
+    _seconds.clear();
+    _minutes.clear();
+    _quarter_hours.clear();
+  }
+};
+
+// A time series store with fixed memory for FixedValue fields, for example to compute the average and the peak of power_delivered
+// in the current quarter hour for the Belgian capacity tariff without an external database:
+//   TimeSeries<DefaultTimeSeriesCapacity, power_delivered, power_returned> history;
+//   history.add(unix_time, data); // after every parsed telegram
+//   const auto& quarter = history.series<power_delivered>().quarter_hours().current();
+//   quarter.average(); quarter.max; // in W, like FixedValue::int_val()
+//
+// Every field keeps circular buffers of the int_val() of its values at a resolution of 1 second, 1 minute and 15 minutes.
+// The aggregate of every period is updated when a value is added, so the aggregate of a period is available in O(1).
+// The time is in seconds and is provided by the caller, for example the Unix time of the device or the timestamp of the telegram.
+template <typename Capacity, typename... Fields>
+class TimeSeries {
+  static_assert((std::is_base_of_v<FixedValue, typename Fields::value_type> && ...), "Only FixedValue fields can be stored in a TimeSeries");
+
+  std::array<FieldTimeSeries<Capacity>, sizeof...(Fields)> _series;
+
+public:
+  // Adds the values of the present fields. The data can contain other fields as well.
+  // Returns false if the time is before the last second that was added to a field. The values of that field are ignored in that case.
+  template <typename... Ts>
+  bool add(const uint32_t time, const ParsedData<Ts...>& data) {
+    bool result = true;
+    ((result &= add_field<Fields>(time, data)), ...);
+    return result;
+  }
+
+  template <typename Field>
+  const FieldTimeSeries<Capacity>& series() const {
+    return _series[index_of<Field>()];
+  }
+
+  void clear() {
+    for (auto& series : _series)
+      series.clear();
+  }
+
+private:
+  template <typename Field, typename Data>
+  bool add_field(const uint32_t time, const Data& data) {
+    const Field& field = data;
+    return !field.present() || _series[index_of<Field>()].add(time, field.val().int_val());
+  }
+
+  template <typename Field>
+  static constexpr size_t index_of() {
+    constexpr std::array<bool, sizeof...(Fields)> matches{std::is_same_v<Field, Fields>...};
+    for (size_t i = 0; i < sizeof...(Fields); ++i) {
+      if (matches[i])
+        return i;
+    }
+    static_assert((std::is_same_v<Field, Fields> || ...), "The field is not in the TimeSeries");
+    return sizeof...(Fields);
+  }
+};
+
+}
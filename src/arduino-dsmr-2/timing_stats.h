@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Optional counters that show where the time goes: framing, CRC, decryption or parsing of the fields.
+// They are enabled with DSMR_TIMING_STATS=1. When it is disabled, timing_stats() doesn't exist, TimingStats only names the counters
+// for the empty helpers below, and neither <atomic> nor <chrono> is included.
+//
+// PacketAccumulator, EncryptedPacketAccumulator and P1Parser add to the process-wide timing_stats().
+// Every counter is a std::atomic updated with relaxed operations, so the statistics can be read from another thread without locks.
+// The counters are independent of each other: a reader can see a packet counted before its bytes.
+// The counters are 64-bit where a 64-bit atomic is lock-free. Elsewhere (e.g. the 32-bit ESP32) they are 32-bit: the byte counters wrap
+// around after 4 GB, and the times are counted in microseconds, so they wrap around after 71 minutes of accumulated time instead of 4.3 seconds.
+//
+// The time is measured with DSMR_TIMING_STATS_CLOCK (std::chrono::steady_clock by default) and stored in TimingStats::Duration units:
+// nanoseconds with 64-bit counters, microseconds with 32-bit counters.
+// Notes:
+//   crc_time only includes the CRC of whole telegrams (P1Parser::parse) and of the chunks copied by PacketAccumulator::process.
+//   PacketAccumulator::process_byte updates the CRC one byte at a time, reading the clock for each byte would cost more than the CRC itself.
+#ifndef DSMR_TIMING_STATS
+#define DSMR_TIMING_STATS 0
+#endif
+
+#if DSMR_TIMING_STATS
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+#ifndef DSMR_TIMING_STATS_CLOCK
+#define DSMR_TIMING_STATS_CLOCK std::chrono::steady_clock
+#endif
+#endif
+
+namespace arduino_dsmr_2 {
+
+struct TimingStats {
+#if DSMR_TIMING_STATS
+  using Value = std::conditional_t<std::atomic<uint64_t>::is_always_lock_free, uint64_t, uint32_t>;
+  using Counter = std::atomic<Value>;
+  using Duration = std::conditional_t<sizeof(Value) == 8, std::chrono::nanoseconds, std::chrono::microseconds>;
+#else
+  // Nothing is counted, the members only exist so that the calls of the empty helpers compile
+  using Value = std::size_t;
+  using Counter = Value;
+#endif
+
+  // The number of values of PacketAccumulator::Error and EncryptedPacketAccumulator::Error. The accumulators check them with a static_assert.
+  static constexpr std::size_t packet_error_count = 5;
+  static constexpr std::size_t encrypted_packet_error_count = 4;
+
+  // PacketAccumulator
+  Counter bytes_consumed{0};
+  Counter packets_emitted{0};
+  std::array<Counter, packet_error_count> packet_errors{}; // indexed by PacketAccumulator::Error
+  Counter crc_time{0};
+
+  // EncryptedPacketAccumulator
+  Counter encrypted_bytes_consumed{0};
+  Counter encrypted_packets_emitted{0};
+  std::array<Counter, encrypted_packet_error_count> encrypted_packet_errors{}; // indexed by EncryptedPacketAccumulator::Error
+  Counter decrypt_time{0};
+
+  // P1Parser::parse
+  Counter telegrams_parsed{0};
+  Counter parse_time{0};
+  Counter slowest_telegram_time{0};
+  Counter field_parse_time{0}; // the sum of all fields, see ParsedData<...>::field_timings() for every field separately
+};
+
+#if DSMR_TIMING_STATS
+struct FieldTimingStats {
+  TimingStats::Counter parses{0};
+  TimingStats::Counter time{0};
+};
+
+struct FieldTiming {
+  const char* name;
+  const FieldTimingStats* stats;
+};
+
+inline TimingStats& timing_stats() {
+  static TimingStats stats;
+  return stats;
+}
+
+template <typename Field>
+FieldTimingStats& field_timing_stats() {
+  static FieldTimingStats stats;
+  return stats;
+}
+#endif
+
+namespace timing {
+
+#if DSMR_TIMING_STATS
+using Clock = DSMR_TIMING_STATS_CLOCK;
+
+class Stopwatch {
+  Clock::time_point _start = Clock::now();
+
+public:
+  // In TimingStats::Duration units
+  TimingStats::Value elapsed() const {
+    return static_cast<TimingStats::Value>(std::chrono::duration_cast<TimingStats::Duration>(Clock::now() - _start).count());
+  }
+};
+
+inline void count(TimingStats::Counter TimingStats::* counter, const TimingStats::Value n = 1) {
+  (timing_stats().*counter).fetch_add(n, std::memory_order_relaxed);
+}
+
+template <typename Error, std::size_t N>
+void count_error(std::array<TimingStats::Counter, N> TimingStats::* counters, const Error error) {
+  const auto index = static_cast<std::size_t>(error);
+  if (index < N)
+    (timing_stats().*counters)[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Calls f and adds the time it took to the counter
+template <typename F>
+auto measure(TimingStats::Counter TimingStats::* counter, F&& f) {
+  struct AddElapsedTime {
+    TimingStats::Counter& time;
+    Stopwatch stopwatch;
+    ~AddElapsedTime() { time.fetch_add(stopwatch.elapsed(), std::memory_order_relaxed); }
+  } add_elapsed_time{timing_stats().*counter, {}};
+  return f();
+}
+
+// Measures a P1Parser::parse call
+class TelegramTimer {
+  Stopwatch _stopwatch;
+
+public:
+  TelegramTimer() = default;
+  TelegramTimer(const TelegramTimer&) = delete;
+  TelegramTimer& operator=(const TelegramTimer&) = delete;
+
+  ~TelegramTimer() {
+    const auto time = _stopwatch.elapsed();
+    auto& stats = timing_stats();
+    stats.telegrams_parsed.fetch_add(1, std::memory_order_relaxed);
+    stats.parse_time.fetch_add(time, std::memory_order_relaxed);
+    auto slowest = stats.slowest_telegram_time.load(std::memory_order_relaxed);
+    while (slowest < time && !stats.slowest_telegram_time.compare_exchange_weak(slowest, time, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+// Measures the parsing of a single field
+template <typename Field>
+class FieldTimer {
+  Stopwatch _stopwatch;
+
+public:
+  FieldTimer() = default;
+  FieldTimer(const FieldTimer&) = delete;
+  FieldTimer& operator=(const FieldTimer&) = delete;
+
+  ~FieldTimer() {
+    const auto time = _stopwatch.elapsed();
+    auto& stats = field_timing_stats<Field>();
+    stats.parses.fetch_add(1, std::memory_order_relaxed);
+    stats.time.fetch_add(time, std::memory_order_relaxed);
+    timing_stats().field_parse_time.fetch_add(time, std::memory_order_relaxed);
+  }
+};
+#else
+inline void count(TimingStats::Counter TimingStats::*, TimingStats::Value = 1) {}
+
+template <typename Error, std::size_t N>
+void count_error(std::array<TimingStats::Counter, N> TimingStats::*, Error) {}
+
+template <typename F>
+auto measure(TimingStats::Counter TimingStats::*, F&& f) {
+  return f();
+}
+
+class TelegramTimer {
+public:
+  TelegramTimer() = default;
+  TelegramTimer(const TelegramTimer&) = delete;
+  TelegramTimer& operator=(const TelegramTimer&) = delete;
+};
+
+template <typename Field>
+class FieldTimer {
+public:
+  FieldTimer() = default;
+  FieldTimer(const FieldTimer&) = delete;
+  FieldTimer& operator=(const FieldTimer&) = delete;
+};
+#endif
+
+// Counts a packet or an error returned by one of the accumulators
+template <typename Result, std::size_t N>
+Result count_result(Result res, TimingStats::Counter TimingStats::* packets, std::array<TimingStats::Counter, N> TimingStats::* errors) {
+  if (res.packet())
+    count(packets);
+  else if (res.error())
+    count_error(errors, *res.error());
+  return res;
+}
+
+}
+
+}
@@ -2,9 +2,11 @@
 
 #include <algorithm>
 #include <array>
+#include <compare>
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace arduino_dsmr_2 {
@@ -32,6 +34,63 @@ public:
   NonCopyableAndNonMovable& operator=(NonCopyableAndNonMovable&&) = delete;
 };
 
+// A string with a fixed capacity that is stored inline, so it never allocates memory on the heap.
+// It has the subset of the std::string interface that is needed to store and read field values.
+// Data that doesn't fit into the capacity is truncated; the parser checks the length before storing a value.
+template <size_t N>
+class FixedString {
+  std::array<char, N + 1> _data{};
+  size_t _size = 0;
+
+public:
+  FixedString() = default;
+  FixedString(std::string_view str) { assign(str.data(), str.size()); }
+
+  FixedString& assign(const char* str, size_t len) {
+    _size = 0;
+    return append(str, len);
+  }
+
+  FixedString& operator=(const char* str) { return assign(str, std::strlen(str)); }
+
+  FixedString& append(const char* str, size_t len) {
+    len = std::min(len, N - _size);
+    if (len == 0) {
+      // str can be null for an empty string, which memcpy doesn't allow
+      _data[_size] = '\0';
+      return *this;
+    }
+    std::memcpy(_data.data() + _size, str, len);
+    _size += len;
+    _data[_size] = '\0';
+    return *this;
+  }
+
+  void clear() { assign("", 0); }
+
+  const char* data() const { return _data.data(); }
+  const char* c_str() const { return _data.data(); }
+  size_t size() const { return _size; }
+  size_t length() const { return _size; }
+  bool empty() const { return _size == 0; }
+  static constexpr size_t max_size() { return N; }
+  static constexpr size_t capacity() { return N; }
+
+  const char* begin() const { return data(); }
+  const char* end() const { return data() + _size; }
+  char operator[](size_t pos) const { return _data[pos]; }
+
+  operator std::string_view() const { return std::string_view(data(), _size); }
+
+  friend bool operator==(const FixedString& lhs, std::string_view rhs) { return std::string_view(lhs) == rhs; }
+
+  template <typename Stream>
+  friend Stream& operator<<(Stream& out, const FixedString& str) {
+    out << std::string_view(str);
+    return out;
+  }
+};
+
 // The ParseResult<T> class wraps the result of a parse function. The type
 // of the result is passed as a template parameter and can be void to
 // not return any result.
@@ -140,6 +199,81 @@ struct ObisId {
       : v{a, b, c, d, e, f} {};
   ObisId() = default;
   bool operator==(const ObisId&) const = default;
+
+  // All 6 bytes packed into one integer. Packed ids sort in the same order as the a-b:c.d.e.f notation.
+  constexpr uint64_t packed() const {
+    uint64_t res = 0;
+    for (const auto& part : v)
+      res = (res << 8) | part;
+    return res;
+  }
+};
+
+// A YYMMDDhhmmssX timestamp of a meter, where X is S for summer time and W for winter time.
+// It is stored as the number of seconds since 2000-01-01 00:00:00 in winter time, so timestamps can be compared and subtracted directly,
+// also around the switch to winter time, when the same hour of the day comes twice.
+struct Timestamp {
+  static constexpr uint32_t invalid_seconds = UINT32_MAX;
+
+  uint32_t seconds = 0;
+  bool summer_time = false;
+
+  // Some meters send a timestamp that isn't a date, like 632525252525W, when the value has no timestamp
+  static constexpr Timestamp invalid() { return Timestamp{invalid_seconds, false}; }
+  constexpr bool valid() const { return seconds != invalid_seconds; }
+
+  constexpr auto operator<=>(const Timestamp&) const = default;
+
+  // The number of seconds from other to this timestamp
+  constexpr int64_t operator-(const Timestamp& other) const { return int64_t{seconds} - int64_t{other.seconds}; }
+
+  // The countries with DSMR meters use CET (UTC+1) as winter time
+  constexpr int64_t unix_time(const int32_t winter_time_utc_offset = 3600) const { return int64_t{seconds} + 946684800 - winter_time_utc_offset; }
+
+  // The time that the meter shows: the number of seconds since 2000-01-01 00:00:00 in the local time, summer time included
+  constexpr uint32_t local_seconds() const { return seconds + (summer_time ? 3600 : 0); }
+
+  // The number of days since 2000-01-01 of the date, for 2000-01-01 to 2099-12-31
+  static constexpr uint32_t days_from_date(const uint32_t year, const uint32_t month, const uint32_t day) {
+    // The year starts in March, so the leap day is the last day of the year
+    const uint32_t y = month <= 2 ? year - 1 : year;
+    const uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    return y * 365 + y / 4 - y / 100 + y / 400 + day_of_year - 730425; // 730425 is the number of days of 2000-01-01 since 0000-03-01
+  }
+
+  // The YYMMDDhhmmssX text. An invalid timestamp has the text 000000000000W.
+  constexpr std::array<char, 13> text() const {
+    std::array<char, 13> result{'0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', 'W'};
+    if (!valid())
+      return result;
+
+    const auto local = local_seconds();
+    // The inverse of days_from_date
+    const uint32_t days = local / 86400 + 730425;
+    const uint32_t era_day = days % 146097;
+    const uint32_t year_of_era = (era_day - era_day / 1460 + era_day / 36524 - era_day / 146096) / 365;
+    const uint32_t day_of_year = era_day - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t shifted_month = (5 * day_of_year + 2) / 153;
+    const uint32_t day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    const uint32_t month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+    const uint32_t year = days / 146097 * 400 + year_of_era + (month <= 2 ? 1 : 0);
+
+    const uint32_t parts[] = {year % 100, month, day, local / 3600 % 24, local / 60 % 60, local % 60};
+    for (size_t i = 0; i < 6; ++i) {
+      result[i * 2] = static_cast<char>('0' + parts[i] / 10);
+      result[i * 2 + 1] = static_cast<char>('0' + parts[i] % 10);
+    }
+    result[12] = summer_time ? 'S' : 'W';
+    return result;
+  }
+
+  // Writes the YYMMDDhhmmssX text, like a timestamp that is stored as a string
+  template <typename Stream>
+  friend Stream& operator<<(Stream& out, const Timestamp& timestamp) {
+    const auto text = timestamp.text();
+    out << std::string_view(text.data(), text.size());
+    return out;
+  }
 };
 
 }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/parser.h"
+
+namespace bench {
+
+// Every field defined in fields.h, so that any telegram of the corpus is parsed completely
+using AllFields = arduino_dsmr_2::ParsedData<
+    arduino_dsmr_2::fields::identification,
+    arduino_dsmr_2::fields::p1_version,
+    arduino_dsmr_2::fields::p1_version_be,
+    arduino_dsmr_2::fields::timestamp,
+    arduino_dsmr_2::fields::equipment_id,
+    arduino_dsmr_2::fields::energy_delivered_lux,
+    arduino_dsmr_2::fields::energy_delivered_tariff1,
+    arduino_dsmr_2::fields::energy_delivered_tariff2,
+    arduino_dsmr_2::fields::energy_delivered_tariff3,
+    arduino_dsmr_2::fields::energy_delivered_tariff4,
+    arduino_dsmr_2::fields::energy_returned_lux,
+    arduino_dsmr_2::fields::energy_returned_tariff1,
+    arduino_dsmr_2::fields::energy_returned_tariff2,
+    arduino_dsmr_2::fields::energy_returned_tariff3,
+    arduino_dsmr_2::fields::energy_returned_tariff4,
+    arduino_dsmr_2::fields::total_imported_energy,
+    arduino_dsmr_2::fields::reactive_energy_delivered_tariff1,
+    arduino_dsmr_2::fields::reactive_energy_delivered_tariff2,
+    arduino_dsmr_2::fields::reactive_energy_delivered_tariff3,
+    arduino_dsmr_2::fields::reactive_energy_delivered_tariff4,
+    arduino_dsmr_2::fields::total_exported_energy,
+    arduino_dsmr_2::fields::reactive_energy_returned_tariff1,
+    arduino_dsmr_2::fields::reactive_energy_returned_tariff2,
+    arduino_dsmr_2::fields::reactive_energy_returned_tariff3,
+    arduino_dsmr_2::fields::reactive_energy_returned_tariff4,
+    arduino_dsmr_2::fields::energy_delivered_tariff1_ch,
+    arduino_dsmr_2::fields::energy_delivered_tariff2_ch,
+    arduino_dsmr_2::fields::energy_returned_tariff1_ch,
+    arduino_dsmr_2::fields::energy_returned_tariff2_ch,
+    arduino_dsmr_2::fields::electricity_tariff,
+    arduino_dsmr_2::fields::power_delivered,
+    arduino_dsmr_2::fields::power_returned,
+    arduino_dsmr_2::fields::reactive_power_delivered,
+    arduino_dsmr_2::fields::reactive_power_returned,
+    arduino_dsmr_2::fields::power_delivered_ch,
+    arduino_dsmr_2::fields::power_returned_ch,
+    arduino_dsmr_2::fields::electricity_threshold,
+    arduino_dsmr_2::fields::electricity_switch_position,
+    arduino_dsmr_2::fields::electricity_failures,
+    arduino_dsmr_2::fields::electricity_long_failures,
+    arduino_dsmr_2::fields::electricity_failure_log,
+    arduino_dsmr_2::fields::electricity_sags_l1,
+    arduino_dsmr_2::fields::voltage_sag_time_l1,
+    arduino_dsmr_2::fields::voltage_sag_l1,
+    arduino_dsmr_2::fields::electricity_sags_l2,
+    arduino_dsmr_2::fields::voltage_sag_time_l2,
+    arduino_dsmr_2::fields::voltage_sag_l2,
+    arduino_dsmr_2::fields::electricity_sags_l3,
+    arduino_dsmr_2::fields::voltage_sag_time_l3,
+    arduino_dsmr_2::fields::voltage_sag_l3,
+    arduino_dsmr_2::fields::electricity_swells_l1,
+    arduino_dsmr_2::fields::voltage_swell_time_l1,
+    arduino_dsmr_2::fields::voltage_swell_l1,
+    arduino_dsmr_2::fields::electricity_swells_l2,
+    arduino_dsmr_2::fields::voltage_swell_time_l2,
+    arduino_dsmr_2::fields::voltage_swell_l2,
+    arduino_dsmr_2::fields::electricity_swells_l3,
+    arduino_dsmr_2::fields::voltage_swell_time_l3,
+    arduino_dsmr_2::fields::voltage_swell_l3,
+    arduino_dsmr_2::fields::message_short,
+    arduino_dsmr_2::fields::message_long,
+    arduino_dsmr_2::fields::voltage_l1,
+    arduino_dsmr_2::fields::voltage_avg_l1,
+    arduino_dsmr_2::fields::voltage_l2,
+    arduino_dsmr_2::fields::voltage_avg_l2,
+    arduino_dsmr_2::fields::voltage_l3,
+    arduino_dsmr_2::fields::voltage_avg_l3,
+    arduino_dsmr_2::fields::voltage,
+    arduino_dsmr_2::fields::frequency,
+    arduino_dsmr_2::fields::abs_power,
+    arduino_dsmr_2::fields::current_l1,
+    arduino_dsmr_2::fields::current_fuse_l1,
+    arduino_dsmr_2::fields::current_l2,
+    arduino_dsmr_2::fields::current_fuse_l2,
+    arduino_dsmr_2::fields::current_l3,
+    arduino_dsmr_2::fields::current_fuse_l3,
+    arduino_dsmr_2::fields::power_delivered_l1,
+    arduino_dsmr_2::fields::power_delivered_l2,
+    arduino_dsmr_2::fields::power_delivered_l3,
+    arduino_dsmr_2::fields::power_returned_l1,
+    arduino_dsmr_2::fields::power_returned_l2,
+    arduino_dsmr_2::fields::power_returned_l3,
+    arduino_dsmr_2::fields::current,
+    arduino_dsmr_2::fields::current_n,
+    arduino_dsmr_2::fields::current_sum,
+    arduino_dsmr_2::fields::reactive_power_delivered_l1,
+    arduino_dsmr_2::fields::reactive_power_delivered_l2,
+    arduino_dsmr_2::fields::reactive_power_delivered_l3,
+    arduino_dsmr_2::fields::reactive_power_returned_l1,
+    arduino_dsmr_2::fields::reactive_power_returned_l2,
+    arduino_dsmr_2::fields::reactive_power_returned_l3,
+    arduino_dsmr_2::fields::apparent_delivery_power,
+    arduino_dsmr_2::fields::apparent_delivery_power_l1,
+    arduino_dsmr_2::fields::apparent_delivery_power_l2,
+    arduino_dsmr_2::fields::apparent_delivery_power_l3,
+    arduino_dsmr_2::fields::apparent_return_power,
+    arduino_dsmr_2::fields::apparent_return_power_l1,
+    arduino_dsmr_2::fields::apparent_return_power_l2,
+    arduino_dsmr_2::fields::apparent_return_power_l3,
+    arduino_dsmr_2::fields::active_demand_power,
+    arduino_dsmr_2::fields::active_demand_abs,
+    arduino_dsmr_2::fields::gas_device_type,
+    arduino_dsmr_2::fields::gas_equipment_id,
+    arduino_dsmr_2::fields::gas_equipment_id_be,
+    arduino_dsmr_2::fields::gas_valve_position,
+    arduino_dsmr_2::fields::gas_delivered,
+    arduino_dsmr_2::fields::gas_delivered_be,
+    arduino_dsmr_2::fields::gas_delivered_text,
+    arduino_dsmr_2::fields::thermal_device_type,
+    arduino_dsmr_2::fields::thermal_equipment_id,
+    arduino_dsmr_2::fields::thermal_valve_position,
+    arduino_dsmr_2::fields::thermal_delivered,
+    arduino_dsmr_2::fields::water_device_type,
+    arduino_dsmr_2::fields::water_equipment_id,
+    arduino_dsmr_2::fields::water_valve_position,
+    arduino_dsmr_2::fields::water_delivered,
+    arduino_dsmr_2::fields::sub_device_type,
+    arduino_dsmr_2::fields::sub_equipment_id,
+    arduino_dsmr_2::fields::sub_valve_position,
+    arduino_dsmr_2::fields::sub_delivered,
+    arduino_dsmr_2::fields::active_energy_import_current_average_demand,
+    arduino_dsmr_2::fields::active_energy_export_current_average_demand,
+    arduino_dsmr_2::fields::reactive_energy_import_current_average_demand,
+    arduino_dsmr_2::fields::reactive_energy_export_current_average_demand,
+    arduino_dsmr_2::fields::apparent_energy_import_current_average_demand,
+    arduino_dsmr_2::fields::apparent_energy_export_current_average_demand,
+    arduino_dsmr_2::fields::active_energy_import_last_completed_demand,
+    arduino_dsmr_2::fields::active_energy_export_last_completed_demand,
+    arduino_dsmr_2::fields::reactive_energy_import_last_completed_demand,
+    arduino_dsmr_2::fields::reactive_energy_export_last_completed_demand,
+    arduino_dsmr_2::fields::apparent_energy_import_last_completed_demand,
+    arduino_dsmr_2::fields::apparent_energy_export_last_completed_demand,
+    arduino_dsmr_2::fields::active_energy_import_maximum_demand_running_month,
+    arduino_dsmr_2::fields::active_energy_import_maximum_demand_last_13_months,
+    arduino_dsmr_2::fields::fw_core_version,
+    arduino_dsmr_2::fields::fw_core_checksum,
+    arduino_dsmr_2::fields::fw_module_version,
+    arduino_dsmr_2::fields::fw_module_checksum>;
+
+}
@@ -0,0 +1,20 @@
+#include "bench.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new to count the heap allocations made by the measured code.
+// The other forms of operator new (nothrow, array) call these by default.
+static std::atomic<std::size_t> number_of_allocations{0};
+
+std::size_t bench::allocation_count() { return number_of_allocations.load(std::memory_order_relaxed); }
+
+void* operator new(const std::size_t size) {
+  number_of_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,43 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/batch_parser.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+// One operation is a batch of 10000 telegrams of the dialects of the corpus that have a CRC.
+// The speedup over 1 thread shows how the batch parser scales with the number of cores.
+BENCHMARK("BatchParser") {
+  std::vector<std::string_view> telegrams;
+  double bytes = 0;
+  while (telegrams.size() < 10000) {
+    for (const auto& telegram : bench::telegrams()) {
+      // The CRC check is a setting of the whole batch
+      if (!telegram.has_crc)
+        continue;
+      telegrams.push_back(telegram.text);
+      bytes += static_cast<double>(telegram.text.size());
+    }
+  }
+  std::vector<bench::AllFields> outputs(telegrams.size());
+  std::vector<ParseResult<void>> results(telegrams.size());
+
+  bench::measure("P1Parser::parse_batch", bytes,
+                 [&] { bench::do_not_optimize(P1Parser::parse_batch(std::span(telegrams), std::span(outputs), std::span(results))); });
+
+  const std::size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t number_of_threads = 1; number_of_threads < cores; number_of_threads *= 2)
+    thread_counts.push_back(number_of_threads);
+  thread_counts.push_back(cores);
+
+  for (const auto number_of_threads : thread_counts) {
+    BatchParser<bench::AllFields> parser({.number_of_threads = number_of_threads});
+    bench::measure("BatchParser/" + std::to_string(number_of_threads) + " threads", bytes,
+                   [&] { bench::do_not_optimize(parser.parse(telegrams, outputs, results)); });
+  }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A minimal benchmark framework.
+// Benchmarks are registered with the BENCHMARK macro, similar to doctest's TEST_CASE.
+// Inside a benchmark, bench::measure runs an operation repeatedly and reports the average time of one run.
+namespace bench {
+
+// Prevents the compiler from optimizing away a computation whose result is not used
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  static const volatile void* volatile sink;
+  sink = &value;
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Number of calls of the global operator new since the start of the program. Implemented in allocations.cpp.
+std::size_t allocation_count();
+
+struct Measurement {
+  std::string name;
+  double ns_per_op;
+  double bytes_per_op;
+  double allocations_per_op;
+
+  double megabytes_per_second() const { return bytes_per_op / ns_per_op * 1e3; }
+};
+
+// All measurements of the current run, in the order they were made
+inline std::vector<Measurement>& results() {
+  static std::vector<Measurement> measurements;
+  return measurements;
+}
+
+// Human readable report. Goes to stderr when the JSON report is written to stdout.
+inline FILE*& report_stream() {
+  static FILE* stream = stdout;
+  return stream;
+}
+
+inline void report(const Measurement& m) {
+  if (m.bytes_per_op > 0) {
+    std::fprintf(report_stream(), "%-60s %12.1f ns/op %10.1f MB/s %8.1f allocs/op\n", m.name.c_str(), m.ns_per_op, m.megabytes_per_second(),
+                 m.allocations_per_op);
+  } else {
+    std::fprintf(report_stream(), "%-60s %12.1f ns/op %8.1f allocs/op\n", m.name.c_str(), m.ns_per_op, m.allocations_per_op);
+  }
+}
+
+inline void write_json_string(FILE* out, const std::string& str) {
+  std::fputc('"', out);
+  for (const char c : str) {
+    if (c == '"' || c == '\\')
+      std::fputc('\\', out);
+    std::fputc(c, out);
+  }
+  std::fputc('"', out);
+}
+
+// Writes all results as a JSON array, so that runs can be compared by a script
+inline void write_json(FILE* out) {
+  std::fprintf(out, "[\n");
+  for (std::size_t i = 0; i < results().size(); ++i) {
+    const auto& m = results()[i];
+    std::fprintf(out, "  {\"name\": ");
+    write_json_string(out, m.name);
+    std::fprintf(out, ", \"ns_per_op\": %.2f, \"bytes_per_op\": %.0f, \"bytes_per_second\": %.0f, \"allocations_per_op\": %.2f}%s\n", m.ns_per_op,
+                 m.bytes_per_op, m.bytes_per_op > 0 ? m.megabytes_per_second() * 1e6 : 0.0, m.allocations_per_op, i + 1 < results().size() ? "," : "");
+  }
+  std::fprintf(out, "]\n");
+}
+
+// Runs `op` until at least `min_duration` has passed and reports the average duration of one run.
+// `bytes_per_op` is the amount of data processed by one run. It is used to calculate the throughput.
+template <typename Op>
+Measurement measure(std::string name, const double bytes_per_op, Op&& op, const std::chrono::nanoseconds min_duration = std::chrono::milliseconds(300)) {
+  using clock = std::chrono::steady_clock;
+
+  // Warm up the caches and the branch predictor
+  op();
+
+  std::size_t iterations = 1;
+  while (true) {
+    const auto allocations_before = allocation_count();
+    const auto start = clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      op();
+    }
+    const auto elapsed = clock::now() - start;
+    const auto allocations = allocation_count() - allocations_before;
+
+    if (elapsed >= min_duration) {
+      const auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+      const auto& n = static_cast<double>(iterations);
+      Measurement m{std::move(name), ns / n, bytes_per_op, static_cast<double>(allocations) / n};
+      report(m);
+      results().push_back(m);
+      return m;
+    }
+    iterations *= 2;
+  }
+}
+
+struct Benchmark {
+  const char* name;
+  void (*run)();
+};
+
+inline std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+struct Registrar {
+  Registrar(const char* name, void (*run)()) { registry().push_back({name, run}); }
+};
+
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+#define BENCHMARK_IMPL(function, name)                                                                                                                         \
+  static void function();                                                                                                                                      \
+  static const bench::Registrar BENCHMARK_CONCAT(function, _registrar)(name, &function);                                                                       \
+  static void function()
+#define BENCHMARK(name) BENCHMARK_IMPL(BENCHMARK_CONCAT(benchmark_, __COUNTER__), name)
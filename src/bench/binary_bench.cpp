@@ -0,0 +1,38 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/binary_serializer.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <array>
+#include <cstdio>
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+// One operation is one telegram. The throughput is relative to the size of the record.
+static void measure_telegram(const bench::Telegram& telegram) {
+  bench::AllFields data;
+  P1Parser::parse(&data, telegram.text.data(), telegram.text.size(), false, telegram.has_crc);
+
+  std::array<char, 4096> record;
+  const auto size = BinarySerializer::encode(data, record);
+  // The same telegram encoded relative to itself, like a log of a meter whose values didn't change
+  std::array<char, 4096> delta_record;
+  const auto delta_size = BinarySerializer::encode(data, delta_record, &data);
+  std::fprintf(bench::report_stream(), "%-60s %zu bytes/telegram, %zu with a reference, %zu as text\n", ("BinarySerializer/" + telegram.name).c_str(), size,
+               delta_size, telegram.text.size());
+
+  bench::measure("BinarySerializer::encode/" + telegram.name, static_cast<double>(size),
+                 [&] { bench::do_not_optimize(BinarySerializer::encode(data, record)); });
+  bench::measure("BinarySerializer::encode with a reference/" + telegram.name, static_cast<double>(delta_size),
+                 [&] { bench::do_not_optimize(BinarySerializer::encode(data, delta_record, &data)); });
+  bench::measure("BinarySerializer::decode/" + telegram.name, static_cast<double>(size), [&] {
+    bench::AllFields decoded;
+    bench::do_not_optimize(BinarySerializer::decode(&decoded, std::span<const char>(record).first(size)));
+    bench::do_not_optimize(decoded);
+  });
+}
+
+BENCHMARK("BinarySerializer") {
+  for (const auto& telegram : bench::telegrams())
+    measure_telegram(telegram);
+}
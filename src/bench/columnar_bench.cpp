@@ -0,0 +1,64 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/columnar_data.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+template <typename>
+struct columnar_of;
+template <typename... Ts>
+struct columnar_of<ParsedData<Ts...>> {
+  using type = ColumnarData<Ts...>;
+};
+using AllColumns = columnar_of<bench::AllFields>::type;
+}
+
+// One operation is a batch of 10000 telegrams of all dialects of the corpus: they are parsed into a vector of ParsedData (array-of-structs)
+// or into ColumnarData (struct-of-arrays), or the power of all telegrams is summed. The throughput of a scan counts 4 bytes per telegram.
+BENCHMARK("ColumnarData") {
+  std::vector<const bench::Telegram*> telegrams;
+  while (telegrams.size() < 10000) {
+    for (const auto& telegram : bench::telegrams())
+      telegrams.push_back(&telegram);
+  }
+  double bytes = 0;
+  for (const auto telegram : telegrams)
+    bytes += static_cast<double>(telegram->text.size());
+  const auto scan_bytes = static_cast<double>(telegrams.size() * sizeof(uint32_t));
+
+  std::vector<bench::AllFields> rows(telegrams.size());
+  bench::measure("ParsedData/parse", bytes, [&] {
+    for (size_t i = 0; i < telegrams.size(); ++i) {
+      rows[i] = bench::AllFields();
+      bench::do_not_optimize(P1Parser::parse(&rows[i], telegrams[i]->text.data(), telegrams[i]->text.size(), false, telegrams[i]->has_crc));
+    }
+  });
+
+  AllColumns columns;
+  bench::measure("ColumnarData/parse", bytes, [&] {
+    columns.clear();
+    columns.resize(telegrams.size());
+    for (size_t i = 0; i < telegrams.size(); ++i) {
+      auto row = columns.row(i);
+      bench::do_not_optimize(P1Parser::parse(&row, telegrams[i]->text.data(), telegrams[i]->text.size(), false, telegrams[i]->has_crc));
+    }
+  });
+
+  bench::measure("ParsedData/scan power_delivered", scan_bytes, [&] {
+    uint64_t sum = 0;
+    for (const auto& row : rows)
+      sum += row.power_delivered_present ? row.power_delivered.int_val() : 0;
+    bench::do_not_optimize(sum);
+  });
+
+  bench::measure("ColumnarData/scan power_delivered", scan_bytes, [&] {
+    uint64_t sum = 0;
+    for (const auto value : columns.column<fields::power_delivered>().values())
+      sum += value;
+    bench::do_not_optimize(sum);
+  });
+}
@@ -0,0 +1,41 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/concentrator.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace arduino_dsmr_2;
+
+// One operation is one telegram from every stream. The telegrams arrive in chunks of 64 bytes,
+// the chunks of all streams are interleaved like data from many serial ports.
+static void measure_streams(const std::size_t number_of_streams, const std::size_t number_of_workers) {
+  const auto& text = bench::telegram("DSMR 5").text;
+  constexpr std::size_t chunk_size = 64;
+
+  Concentrator<bench::AllFields> concentrator({.number_of_streams = number_of_streams,
+                                               .number_of_workers = number_of_workers,
+                                               .buffer_size = 2048,
+                                               .result_queue_capacity = number_of_streams});
+
+  const auto name = std::to_string(number_of_streams) + " streams, " + std::to_string(number_of_workers) + " workers";
+  bench::measure("Concentrator/" + name, static_cast<double>(text.size() * number_of_streams), [&] {
+    for (std::size_t offset = 0; offset < text.size(); offset += chunk_size) {
+      const auto chunk = std::string_view(text).substr(offset, chunk_size);
+      for (std::size_t stream = 0; stream < number_of_streams; ++stream)
+        concentrator.push(stream, chunk);
+    }
+    for (std::size_t i = 0; i < number_of_streams; ++i)
+      bench::do_not_optimize(concentrator.pop());
+  });
+}
+
+BENCHMARK("Concentrator") {
+  const std::size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+  for (const std::size_t number_of_streams : {1u, 10u, 100u, 1000u, 10000u}) {
+    measure_streams(number_of_streams, 1);
+    if (cores > 1)
+      measure_streams(number_of_streams, cores);
+  }
+}
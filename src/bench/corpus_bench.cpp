@@ -0,0 +1,55 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/packet_accumulator.h"
+#include "arduino-dsmr-2/parser.h"
+#include "arduino-dsmr-2/stream_parser.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+// One operation is one telegram, so ns/op is ns/telegram and allocs/op is allocations/telegram
+static void measure_telegram(const bench::Telegram& telegram) {
+  const auto& text = telegram.text;
+  const auto& bytes = static_cast<double>(text.size());
+  const char* const data_begin = text.data() + 1;
+  const char* const data_end = text.data() + text.find('!');
+
+  bench::AllFields check;
+  if (const auto& res = P1Parser::parse(&check, text.data(), text.size(), true, telegram.has_crc); res.err) {
+    std::fprintf(bench::report_stream(), "%s doesn't parse: %s\n", telegram.name.c_str(), res.fullError(text.data(), text.data() + text.size()).c_str());
+  }
+
+  std::vector<char> buffer(4000);
+  PacketAccumulator accumulator(buffer, telegram.has_crc);
+  bench::measure("PacketAccumulator::process_byte/" + telegram.name, bytes, [&] {
+    for (const auto& byte : text)
+      bench::do_not_optimize(accumulator.process_byte(byte));
+  });
+  bench::measure("PacketAccumulator::process/" + telegram.name, bytes,
+                 [&] { accumulator.process(text, [](const PacketAccumulator::Result& res) { bench::do_not_optimize(res); }); });
+
+  bench::measure("P1Parser::parse/" + telegram.name, bytes, [&] {
+    bench::AllFields data;
+    bench::do_not_optimize(P1Parser::parse(&data, text.data(), text.size(), false, telegram.has_crc));
+    bench::do_not_optimize(data);
+  });
+
+  bench::measure("P1Parser::parse_data/" + telegram.name, static_cast<double>(data_end - data_begin), [&] {
+    bench::AllFields data;
+    bench::do_not_optimize(P1Parser::parse_data(&data, data_begin, data_end));
+    bench::do_not_optimize(data);
+  });
+
+  // Receives and parses the telegram in one pass, compare with PacketAccumulator::process + P1Parser::parse
+  std::vector<char> line_buffer(1024);
+  StreamParser<bench::AllFields> stream_parser(line_buffer, telegram.has_crc);
+  bench::measure("StreamParser::process/" + telegram.name, bytes,
+                 [&] { stream_parser.process(text, [](const StreamParser<bench::AllFields>::Result& res) { bench::do_not_optimize(res); }); });
+}
+
+BENCHMARK("Telegram corpus") {
+  for (const auto& telegram : bench::telegrams())
+    measure_telegram(telegram);
+}
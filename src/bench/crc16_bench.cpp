@@ -0,0 +1,42 @@
+#include "arduino-dsmr-2/crc16.h"
+#include "bench.h"
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+// A typical telegram is 1-4 KB, so measure the CRC over a 4 KB buffer
+static std::string make_data() {
+  std::string data;
+  while (data.size() < 4096) {
+    data += "1-0:1.8.1(000671.578*kWh)\r\n";
+  }
+  data.resize(4096);
+  return data;
+}
+
+template <typename Implementation>
+static void measure_buffer(const char* name, const std::string& data) {
+  bench::measure(name, static_cast<double>(data.size()), [&] { bench::do_not_optimize(Implementation::update(0, data.data(), data.size())); });
+}
+
+template <typename Implementation>
+static void measure_byte_by_byte(const char* name, const std::string& data) {
+  bench::measure(name, static_cast<double>(data.size()), [&] {
+    uint16_t crc = 0;
+    for (const auto& byte : data) {
+      crc = Implementation::update(crc, static_cast<uint8_t>(byte));
+    }
+    bench::do_not_optimize(crc);
+  });
+}
+
+BENCHMARK("CRC16 over a 4 KB buffer") {
+  const auto& data = make_data();
+  measure_buffer<Crc16Bitwise>("crc16/bitwise", data);
+  measure_buffer<Crc16Table>("crc16/table", data);
+  measure_buffer<Crc16SlicingBy4>("crc16/slicing_by_4", data);
+  measure_buffer<Crc16SlicingBy8>("crc16/slicing_by_8", data);
+  measure_buffer<Crc16Clmul>("crc16/clmul", data);
+  measure_byte_by_byte<Crc16Bitwise>("crc16/bitwise byte by byte", data);
+  measure_byte_by_byte<Crc16Table>("crc16/table byte by byte", data);
+}
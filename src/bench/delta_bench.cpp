@@ -0,0 +1,48 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/delta_parser.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <cstdio>
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+// The telegram with another value of the power delivered (1-0:1.7.0) and a new CRC
+std::string with_other_power(const std::string& text) {
+  auto result = text;
+  const auto value = result.find('(', result.find("1-0:1.7.0(")) + 1;
+  result[value + 1] = result[value + 1] == '1' ? '2' : '1';
+
+  const auto crc_position = result.find('!') + 1;
+  char crc[5];
+  std::snprintf(crc, sizeof(crc), "%04X", Crc16::update(0, result.data(), crc_position));
+  result.replace(crc_position, 4, crc);
+  return result;
+}
+}
+
+// One operation is one telegram. A DSMR 5 meter sends a telegram every second, and usually only the power and the voltages change.
+BENCHMARK("DeltaParser") {
+  const auto& text = bench::telegram("DSMR 5").text;
+  const auto other = with_other_power(text);
+  const auto bytes = static_cast<double>(text.size());
+
+  bench::measure("P1Parser::parse/DSMR 5", bytes, [&] {
+    bench::AllFields data;
+    bench::do_not_optimize(P1Parser::parse(&data, text.data(), text.size()));
+    bench::do_not_optimize(data);
+  });
+
+  DeltaParser<bench::AllFields> parser;
+  if (const auto& res = parser.parse(other.data(), other.size()); res.err)
+    std::fprintf(bench::report_stream(), "The changed telegram doesn't parse: %s\n", res.err);
+
+  bench::measure("DeltaParser::parse/DSMR 5, nothing changes", bytes, [&] { bench::do_not_optimize(parser.parse(text.data(), text.size())); });
+
+  bool odd = false;
+  bench::measure("DeltaParser::parse/DSMR 5, the power changes", bytes, [&] {
+    const auto& telegram = (odd = !odd) ? other : text;
+    bench::do_not_optimize(parser.parse(telegram.data(), telegram.size()));
+  });
+}
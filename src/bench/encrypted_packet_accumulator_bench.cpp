@@ -0,0 +1,61 @@
+#include "arduino-dsmr-2/encrypted_packet_accumulator.h"
+#include "bench.h"
+#include "encryption.h"
+#include "telegrams.h"
+#include <array>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+static constexpr std::array<uint8_t, 16> key = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+
+static bool decrypt(mbedtls_gcm_context& gcm, const std::vector<uint8_t>& packet, std::span<char> output) {
+  constexpr uint8_t aad[] = {0x30, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+  const std::array<uint8_t, 12> iv = {packet[2], packet[3], packet[4], packet[5], packet[6], packet[7], packet[8], packet[9], packet[14], packet[15], packet[16], packet[17]};
+  const auto telegram_size = packet.size() - 18 - 12;
+  return mbedtls_gcm_auth_decrypt(&gcm, telegram_size, iv.data(), iv.size(), aad, sizeof(aad), packet.data() + 18 + telegram_size, 12, packet.data() + 18,
+                                  reinterpret_cast<unsigned char*>(output.data())) == 0;
+}
+
+// The way EncryptedPacketAccumulator used to decrypt: with a new context and a new key schedule for every packet
+static bool decrypt_with_new_context(const std::vector<uint8_t>& packet, std::span<char> output) {
+  mbedtls_gcm_context gcm;
+  mbedtls_gcm_init(&gcm);
+  mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key.data(), 128);
+  const auto res = decrypt(gcm, packet, output);
+  mbedtls_gcm_free(&gcm);
+  return res;
+}
+
+BENCHMARK("EncryptedPacketAccumulator decryption") {
+  const auto& packet = bench::encrypt_telegram(bench::telegram("Luxembourg").text, key, 1);
+  std::vector<uint8_t> encrypted_packet_buffer(4000);
+  std::vector<char> decrypted_packet_buffer(4000);
+
+  const auto& with_new_context = bench::measure("GCM/new context and key schedule per packet", static_cast<double>(packet.size()),
+                                                [&] { bench::do_not_optimize(decrypt_with_new_context(packet, decrypted_packet_buffer)); });
+
+  mbedtls_gcm_context gcm;
+  mbedtls_gcm_init(&gcm);
+  mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key.data(), 128);
+  const auto& with_reused_context = bench::measure("GCM/reused context", static_cast<double>(packet.size()),
+                                                   [&] { bench::do_not_optimize(decrypt(gcm, packet, decrypted_packet_buffer)); });
+  mbedtls_gcm_free(&gcm);
+
+  std::fprintf(bench::report_stream(), "  packets/s: new context %.0f, reused context %.0f\n", 1e9 / with_new_context.ns_per_op,
+               1e9 / with_reused_context.ns_per_op);
+
+  EncryptedPacketAccumulator accumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA");
+  bench::measure("EncryptedPacketAccumulator::process_byte/whole packet", static_cast<double>(packet.size()), [&] {
+    for (const auto& byte : packet)
+      bench::do_not_optimize(accumulator.process_byte(byte));
+  });
+
+  EncryptedPacketAccumulator in_place_accumulator(decrypted_packet_buffer);
+  in_place_accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA");
+  bench::measure("EncryptedPacketAccumulator::process_byte/in place", static_cast<double>(packet.size()), [&] {
+    for (const auto& byte : packet)
+      bench::do_not_optimize(in_place_accumulator.process_byte(byte));
+  });
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mbedtls/gcm.h>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Encrypts a telegram the way a Luxembourg Smarty meter does:
+//   Header (18 bytes) | Telegram encrypted with AES-128-GCM | GCM Tag (12 bytes)
+// See src/test/test_data/generate_encrypted_packet.py for the description of the fields.
+inline std::vector<uint8_t> encrypt_telegram(const std::string& telegram, const std::array<uint8_t, 16>& key, const uint32_t invocation_counter) {
+  const std::array<uint8_t, 8> system_title = {'S', 'Y', 'S', 'T', 'E', 'M', 'I', 'D'};
+  const std::array<uint8_t, 4> ic = {static_cast<uint8_t>(invocation_counter >> 24), static_cast<uint8_t>(invocation_counter >> 16),
+                                     static_cast<uint8_t>(invocation_counter >> 8), static_cast<uint8_t>(invocation_counter)};
+  const std::array<uint8_t, 12> iv = {system_title[0], system_title[1], system_title[2], system_title[3], system_title[4], system_title[5],
+                                      system_title[6], system_title[7], ic[0],           ic[1],           ic[2],           ic[3]};
+  constexpr uint8_t aad[] = {0x30, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+  const auto total_length = static_cast<uint16_t>(1 + 4 + telegram.size() + 12);
+  std::vector<uint8_t> packet = {0xDB, 0x08};
+  packet.insert(packet.end(), system_title.begin(), system_title.end());
+  packet.insert(packet.end(), {0x82, static_cast<uint8_t>(total_length >> 8), static_cast<uint8_t>(total_length), 0x30});
+  packet.insert(packet.end(), ic.begin(), ic.end());
+
+  const auto header_size = packet.size();
+  packet.resize(header_size + telegram.size() + 12);
+
+  mbedtls_gcm_context gcm;
+  mbedtls_gcm_init(&gcm);
+  mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key.data(), 128);
+  mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, telegram.size(), iv.data(), iv.size(), aad, sizeof(aad),
+                            reinterpret_cast<const unsigned char*>(telegram.data()), packet.data() + header_size, 12,
+                            packet.data() + header_size + telegram.size());
+  mbedtls_gcm_free(&gcm);
+  return packet;
+}
+
+}
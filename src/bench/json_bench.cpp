@@ -0,0 +1,65 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/json_writer.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <array>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+// The usual ad-hoc converter: an applyEach visitor that writes into an std::ostringstream
+struct OstreamJsonVisitor {
+  std::ostringstream& out;
+  bool first = true;
+
+  template <typename Item>
+  void apply(Item& item) {
+    if (!item.present())
+      return;
+    out << (first ? "{\"" : ",\"") << Item::name << "\":";
+    first = false;
+
+    using Value = typename Item::value_type;
+    if constexpr (std::is_same_v<Value, FixedValue> || is_timestamped_value<Value>::value)
+      out << item.val().val();
+    else if constexpr (std::is_integral_v<Value>)
+      out << +item.val();
+    else if constexpr (std::is_same_v<Value, Timestamp>)
+      out << '"' << std::string_view(item.val().text().data(), 13) << '"';
+    else
+      out << '"' << std::string_view(item.val()) << '"';
+  }
+};
+
+std::string to_json_with_ostream(bench::AllFields& data) {
+  std::ostringstream out;
+  OstreamJsonVisitor visitor{out};
+  data.applyEach(visitor);
+  out << (visitor.first ? "{}" : "}");
+  return out.str();
+}
+}
+
+// One operation is one telegram. The throughput is relative to the size of the JSON.
+static void measure_telegram(const bench::Telegram& telegram) {
+  bench::AllFields data;
+  P1Parser::parse(&data, telegram.text.data(), telegram.text.size(), false, telegram.has_crc);
+
+  std::array<char, 8192> buffer;
+  const auto size = JsonWriter::write(data, buffer);
+  const auto size_with_units = JsonWriter::write(data, buffer, true);
+
+  bench::measure("JsonWriter::write/" + telegram.name, static_cast<double>(size), [&] { bench::do_not_optimize(JsonWriter::write(data, buffer)); });
+  bench::measure("JsonWriter::write with units/" + telegram.name, static_cast<double>(size_with_units),
+                 [&] { bench::do_not_optimize(JsonWriter::write(data, buffer, true)); });
+  bench::measure("std::ostringstream visitor/" + telegram.name, static_cast<double>(size), [&] { bench::do_not_optimize(to_json_with_ostream(data)); });
+}
+
+BENCHMARK("JsonWriter") {
+  for (const auto& telegram : bench::telegrams())
+    measure_telegram(telegram);
+}
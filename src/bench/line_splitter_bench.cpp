@@ -0,0 +1,80 @@
+#include "arduino-dsmr-2/line_splitter.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+// The way P1Parser::parse_data used to split lines: look at every character one at a time
+template <typename OnLine>
+static ParseResult<void> split_byte_by_byte(const char* str, const char* end, OnLine&& on_line) {
+  const char* line_start = str;
+  const char* line_end = str;
+  bool open_bracket_found = false;
+  while (line_end < end) {
+    const char c = *line_end;
+    if (c == '(') {
+      if (open_bracket_found)
+        return ParseResult<void>().fail("Unexpected '(' symbol", line_end);
+      open_bracket_found = true;
+    } else if (c == ')') {
+      if (!open_bracket_found)
+        return ParseResult<void>().fail("Unexpected ')' symbol", line_end);
+      open_bracket_found = false;
+    } else if (c == '\r' || c == '\n') {
+      const bool next_part_of_the_data_line_on_next_line = (end - line_end > 2) && (line_end[1] == '(' || line_end[2] == '(');
+      if (!open_bracket_found && !next_part_of_the_data_line_on_next_line) {
+        ParseResult<void> tmp = on_line(line_start, line_end);
+        if (tmp.err)
+          return tmp;
+        line_start = line_end + 1;
+      }
+    }
+    ++line_end;
+  }
+
+  if (line_end != line_start)
+    return ParseResult<void>().fail("Last dataline not CRLF terminated", line_end);
+  return ParseResult<void>();
+}
+
+static ParseResult<void> count_line(std::size_t& lines) {
+  ++lines;
+  return ParseResult<void>();
+}
+
+// Splits the data part of every telegram of the corpus, i.e. everything between the identification line and the '!'
+template <typename Split>
+static void measure_corpus(const std::string& name, Split&& split) {
+  double bytes = 0;
+  for (const auto& telegram : bench::telegrams())
+    bytes += static_cast<double>(telegram.text.find('!') - telegram.text.find('\n') - 1);
+
+  bench::measure(name, bytes, [&] {
+    std::size_t lines = 0;
+    for (const auto& telegram : bench::telegrams()) {
+      const char* data = telegram.text.data() + telegram.text.find('\n') + 1;
+      const char* end = telegram.text.data() + telegram.text.find('!');
+      bench::do_not_optimize(split(data, end, [&](const char*, const char*) { return count_line(lines); }));
+    }
+    bench::do_not_optimize(lines);
+  });
+}
+
+BENCHMARK("split_logical_lines over the telegram corpus") {
+  measure_corpus("split_logical_lines/byte by byte", [](const char* str, const char* end, auto&& on_line) { return split_byte_by_byte(str, end, on_line); });
+  measure_corpus("split_logical_lines/ScalarStructuralScanner",
+                 [](const char* str, const char* end, auto&& on_line) { return split_logical_lines<ScalarStructuralScanner>(str, end, on_line); });
+#ifdef DSMR_HAS_SSE2
+  measure_corpus("split_logical_lines/Sse2StructuralScanner",
+                 [](const char* str, const char* end, auto&& on_line) { return split_logical_lines<Sse2StructuralScanner>(str, end, on_line); });
+#endif
+#ifdef DSMR_HAS_AVX2
+  measure_corpus("split_logical_lines/Avx2StructuralScanner",
+                 [](const char* str, const char* end, auto&& on_line) { return split_logical_lines<Avx2StructuralScanner>(str, end, on_line); });
+#endif
+#ifdef DSMR_HAS_NEON
+  measure_corpus("split_logical_lines/NeonStructuralScanner",
+                 [](const char* str, const char* end, auto&& on_line) { return split_logical_lines<NeonStructuralScanner>(str, end, on_line); });
+#endif
+}
@@ -0,0 +1,31 @@
+#include "bench.h"
+#include <string_view>
+
+// Usage: arduino_dsmr_bench [--json] [filter]
+// Runs all benchmarks whose name contains the filter string.
+// With --json, the results are written to stdout as JSON and the human readable report goes to stderr.
+int main(int argc, char** argv) {
+  bool json = false;
+  std::string_view filter;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--json")
+      json = true;
+    else
+      filter = arg;
+  }
+
+  if (json)
+    bench::report_stream() = stderr;
+
+  for (const auto& benchmark : bench::registry()) {
+    if (std::string_view(benchmark.name).find(filter) == std::string_view::npos) {
+      continue;
+    }
+    std::fprintf(bench::report_stream(), "\n%s\n", benchmark.name);
+    benchmark.run();
+  }
+
+  if (json)
+    bench::write_json(stdout);
+}
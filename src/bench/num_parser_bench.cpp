@@ -0,0 +1,84 @@
+#include "arduino-dsmr-2/parser.h"
+#include "bench.h"
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+// The way NumParser::parse used to work: strchr and a multiplication for every digit
+static ParseResult<uint32_t> parse_digit_by_digit(size_t max_decimals, const char* unit, const char* str, const char* end) {
+  ParseResult<uint32_t> res;
+  if (str >= end || *str != '(')
+    return res.fail("Missing (", str);
+
+  const char* num_end = str + 1;
+  uint32_t value = 0;
+  while (num_end < end && !strchr("*.)", *num_end)) {
+    if (*num_end < '0' || *num_end > '9')
+      return res.fail(INVALID_NUMBER, num_end);
+    value = value * 10 + static_cast<uint32_t>(*num_end++ - '0');
+  }
+
+  if (max_decimals && num_end < end && *num_end == '.') {
+    ++num_end;
+    while (num_end < end && !strchr("*)", *num_end) && max_decimals) {
+      max_decimals--;
+      if (*num_end < '0' || *num_end > '9')
+        return res.fail(INVALID_NUMBER, num_end);
+      value = value * 10 + static_cast<uint32_t>(*num_end++ - '0');
+    }
+  }
+
+  while (max_decimals--)
+    value *= 10;
+
+  if (unit && *unit && (num_end >= end || (*num_end != '*' && *num_end != '.')) && value == 0) {
+    num_end = std::find(num_end, end, ')');
+  } else if (unit && *unit) {
+    if (num_end >= end || *num_end != '*')
+      return res.fail("Missing unit", num_end);
+    const char* unit_start = ++num_end;
+    while (num_end < end && *num_end != ')' && *unit) {
+      if (std::tolower(static_cast<unsigned char>(*num_end++)) != std::tolower(static_cast<unsigned char>(*unit++)))
+        return res.fail(INVALID_UNIT, unit_start);
+    }
+    if (*unit)
+      return res.fail(INVALID_UNIT, unit_start);
+  }
+
+  if (num_end >= end || *num_end != ')')
+    return res.fail("Extra data", num_end);
+  return res.succeed(value).until(num_end + 1);
+}
+
+struct Value {
+  std::string text;
+  size_t max_decimals;
+  const char* unit;
+};
+
+// Typical values of a DSMR 5 telegram
+static const std::vector<Value> values = {
+    {"(123456.789*kWh)", 3, "kWh"}, {"(123456.789*kWh)", 3, "kWh"}, {"(123456.789*kWh)", 3, "kWh"}, {"(123456.789*kWh)", 3, "kWh"},
+    {"(01.193*kW)", 3, "kW"},       {"(00.000*kW)", 3, "kW"},       {"(00004)", 0, ""},             {"(00002)", 0, ""},
+    {"(0000000240*s)", 0, "s"},     {"(220.1*V)", 3, "V"},          {"(220.2*V)", 3, "V"},          {"(220.3*V)", 3, "V"},
+    {"(001*A)", 3, "A"},            {"(002*A)", 3, "A"},            {"(003*A)", 3, "A"},            {"(01.111*kW)", 3, "kW"},
+    {"(02.222*kW)", 3, "kW"},       {"(03.333*kW)", 3, "kW"},       {"(12785.123*m3)", 3, "m3"},    {"(006545766*Wh)", 0, "Wh"},
+    {"(003897726*varh)", 0, "varh"}};
+
+template <typename Parse>
+static void measure_values(const char* name, Parse&& parse) {
+  double bytes = 0;
+  for (const auto& v : values)
+    bytes += static_cast<double>(v.text.size());
+
+  bench::measure(name, bytes, [&] {
+    for (const auto& v : values)
+      bench::do_not_optimize(parse(v.max_decimals, v.unit, v.text.data(), v.text.data() + v.text.size()));
+  });
+}
+
+BENCHMARK("NumParser::parse") {
+  measure_values("NumParser::parse/digit by digit", parse_digit_by_digit);
+  measure_values("NumParser::parse/SWAR", NumParser::parse);
+}
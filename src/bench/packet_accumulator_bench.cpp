@@ -0,0 +1,35 @@
+#include "arduino-dsmr-2/packet_accumulator.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <cstdio>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+// One operation is one telegram. Compares feeding the telegram byte by byte with feeding it as one chunk, with and without the CRC check.
+static void measure_telegram(const bench::Telegram& telegram) {
+  const auto& text = telegram.text;
+  const auto bytes = static_cast<double>(text.size());
+  std::vector<char> buffer(4000);
+
+  for (const bool check_crc : {true, false}) {
+    if (check_crc && !telegram.has_crc)
+      continue;
+
+    const std::string suffix = (check_crc ? " with CRC/" : " without CRC/") + telegram.name;
+    PacketAccumulator accumulator(buffer, check_crc);
+    const auto by_byte = bench::measure("PacketAccumulator::process_byte" + suffix, bytes, [&] {
+      for (const auto& byte : text)
+        bench::do_not_optimize(accumulator.process_byte(byte));
+    });
+    const auto by_chunk = bench::measure("PacketAccumulator::process" + suffix, bytes, [&] {
+      accumulator.process(text, [](const PacketAccumulator::Result& res) { bench::do_not_optimize(res); });
+    });
+    std::fprintf(bench::report_stream(), "%-60s %12.1fx\n", ("process / process_byte" + suffix).c_str(), by_byte.ns_per_op / by_chunk.ns_per_op);
+  }
+}
+
+BENCHMARK("PacketAccumulator") {
+  for (const auto& telegram : bench::telegrams())
+    measure_telegram(telegram);
+}
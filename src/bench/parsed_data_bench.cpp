@@ -0,0 +1,105 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/parser.h"
+#include "bench.h"
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+// The way ParsedData::parse_line used to find a field: compare the id with every field one after another
+template <typename... Ts>
+static ParseResult<void> parse_line_linear_search(ParsedData<Ts...>& data, const ObisId& obisId, const char* str, const char* end) {
+  ParseResult<void> res;
+  const auto& try_one = [&](auto& field) -> bool {
+    using FieldType = std::decay_t<decltype(field)>;
+    if (obisId != FieldType::id) {
+      return false;
+    }
+
+    if (field.present())
+      res = ParseResult<void>().fail("Duplicate field", str);
+    else {
+      field.present() = true;
+      res = field.parse(str, end);
+    }
+    return true;
+  };
+
+  const bool found = (try_one(static_cast<Ts&>(data)) || ...);
+  return found ? res : ParseResult<void>().until(str);
+}
+
+struct MarkPresent {
+  template <typename Field>
+  void apply(Field& field) {
+    field.present() = true;
+  }
+};
+
+// Looks up the id of every field plus the same amount of unknown ids.
+// All fields are marked as present, so a found field only costs the "Duplicate field" check
+// and the measurement shows the cost of finding the field.
+template <typename... Ts>
+static void measure_dispatch(const std::string& name, ParsedData<Ts...>* = nullptr) {
+  ParsedData<Ts...> data;
+  data.applyEach(MarkPresent());
+
+  std::vector<ObisId> ids = {Ts::id...};
+  for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+    ids.push_back(ObisId(1, 0, static_cast<uint8_t>(200 + i % 50), 7, 0));
+  }
+
+  const char value[] = "(1)";
+  const auto& lookups = static_cast<double>(ids.size());
+
+  const auto& linear = bench::measure(name + " linear search", 0, [&] {
+    for (const auto& id : ids) {
+      bench::do_not_optimize(parse_line_linear_search(data, id, value, value + 3));
+    }
+  });
+  const auto& sorted = bench::measure(name + " sorted dispatch", 0, [&] {
+    for (const auto& id : ids) {
+      bench::do_not_optimize(data.parse_line(id, value, value + 3));
+    }
+  });
+  std::fprintf(bench::report_stream(), "  per lookup: linear search %.1f ns, sorted dispatch %.1f ns\n", linear.ns_per_op / lookups,
+               sorted.ns_per_op / lookups);
+}
+
+BENCHMARK("ParsedData::parse_line field lookup") {
+  measure_dispatch<identification, p1_version, timestamp, equipment_id, energy_delivered_tariff1>("parse_line/5 fields");
+
+  measure_dispatch<identification,
+                   p1_version,
+                   p1_version_be,
+                   timestamp,
+                   equipment_id,
+                   energy_delivered_lux,
+                   energy_delivered_tariff1,
+                   energy_delivered_tariff2,
+                   energy_delivered_tariff3,
+                   energy_delivered_tariff4,
+                   energy_returned_lux,
+                   energy_returned_tariff1,
+                   energy_returned_tariff2,
+                   energy_returned_tariff3,
+                   energy_returned_tariff4,
+                   total_imported_energy,
+                   reactive_energy_delivered_tariff1,
+                   reactive_energy_delivered_tariff2,
+                   reactive_energy_delivered_tariff3,
+                   reactive_energy_delivered_tariff4,
+                   total_exported_energy,
+                   reactive_energy_returned_tariff1,
+                   reactive_energy_returned_tariff2,
+                   reactive_energy_returned_tariff3,
+                   reactive_energy_returned_tariff4,
+                   energy_delivered_tariff1_ch,
+                   energy_delivered_tariff2_ch,
+                   energy_returned_tariff1_ch,
+                   energy_returned_tariff2_ch,
+                   electricity_tariff>("parse_line/30 fields");
+
+  measure_dispatch("parse_line/138 fields", static_cast<bench::AllFields*>(nullptr));
+}
@@ -0,0 +1,38 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/parser.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <string>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+// A typical energy monitor only needs a few fields
+using ThreeFields = ParsedData<energy_delivered_tariff1, energy_delivered_tariff2, power_delivered>;
+
+// One operation is one telegram
+template <typename Data>
+static void measure_fields(const std::string& fields_name, const bench::Telegram& telegram) {
+  const auto& text = telegram.text;
+  const auto& bytes = static_cast<double>(text.size());
+
+  bench::measure("P1Parser::parse/" + fields_name + "/" + telegram.name, bytes, [&] {
+    Data data;
+    bench::do_not_optimize(P1Parser::parse(&data, text.data(), text.size(), false, telegram.has_crc));
+    bench::do_not_optimize(data);
+  });
+
+  bench::measure("P1Parser::parse_selected/" + fields_name + "/" + telegram.name, bytes, [&] {
+    Data data;
+    bench::do_not_optimize(P1Parser::parse_selected(&data, text.data(), text.size(), telegram.has_crc));
+    bench::do_not_optimize(data);
+  });
+}
+
+BENCHMARK("Selected fields") {
+  for (const auto& telegram : bench::telegrams()) {
+    measure_fields<ThreeFields>("3 fields", telegram);
+    measure_fields<bench::AllFields>("all fields", telegram);
+  }
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "arduino-dsmr-2/crc16.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Telegrams from real meters of different countries and DSMR versions.
+// The DSMR 4 telegram is the fixture of parser_test.cpp, the others follow the same layout with the fields of their dialect.
+namespace bench {
+
+struct Telegram {
+  std::string name;
+  // The complete telegram from '/' to the end of the checksum line
+  std::string text;
+  bool has_crc;
+};
+
+// Appends "!" and the checksum (if the dialect has one) to the data part of a telegram
+inline std::string finish_telegram(const std::string& data, const bool with_crc) {
+  std::string text = data + "!";
+  if (with_crc) {
+    char crc[5];
+    std::snprintf(crc, sizeof(crc), "%04X", arduino_dsmr_2::Crc16::update(0, text.data(), text.size()));
+    text += crc;
+  }
+  return text + "\r\n";
+}
+
+inline const std::vector<Telegram>& telegrams() {
+  static const std::vector<Telegram> corpus = {
+      {"DSMR 2.2", finish_telegram("/ISk5\\2ME382-1003\r\n"
+                                   "\r\n"
+                                   "0-0:96.1.1(4B414C37303035313033303035333135)\r\n"
+                                   "1-0:1.8.1(00608.060*kWh)\r\n"
+                                   "1-0:1.8.2(00406.093*kWh)\r\n"
+                                   "1-0:2.8.1(00000.000*kWh)\r\n"
+                                   "1-0:2.8.2(00000.000*kWh)\r\n"
+                                   "0-0:96.14.0(0001)\r\n"
+                                   "1-0:1.7.0(0000.39*kW)\r\n"
+                                   "1-0:2.7.0(0000.00*kW)\r\n"
+                                   "0-0:17.0.0(0999.00*kW)\r\n"
+                                   "0-0:96.3.10(1)\r\n"
+                                   "0-0:96.13.1()\r\n"
+                                   "0-0:96.13.0()\r\n"
+                                   "0-1:24.1.0(3)\r\n"
+                                   "0-1:96.1.0(3238303131303031333036333032363133)\r\n"
+                                   "0-1:24.3.0(130101220000)(00)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                                   "(00384.473)\r\n"
+                                   "0-1:24.4.0(1)\r\n",
+                                   false), false},
+      {"DSMR 4", finish_telegram("/KFM5KAIFA-METER\r\n"
+                                 "\r\n"
+                                 "1-3:0.2.8(40)\r\n"
+                                 "0-0:1.0.0(150117185916W)\r\n"
+                                 "0-0:96.1.1(0000000000000000000000000000000000)\r\n"
+                                 "1-0:1.8.1(000671.578*kWh)\r\n"
+                                 "1-0:1.8.2(000842.472*kWh)\r\n"
+                                 "1-0:2.8.1(000000.000*kWh)\r\n"
+                                 "1-0:2.8.2(000000.000*kWh)\r\n"
+                                 "0-0:96.14.0(0001)\r\n"
+                                 "1-0:1.7.0(00.333*kW)\r\n"
+                                 "1-0:2.7.0(00.000*kW)\r\n"
+                                 "0-0:17.0.0(999.9*kW)\r\n"
+                                 "0-0:96.3.10(1)\r\n"
+                                 "0-0:96.7.21(00008)\r\n"
+                                 "0-0:96.7.9(00007)\r\n"
+                                 "1-0:99.97.0(1)(0-0:96.7.19)(000101000001W)(2147483647*s)\r\n"
+                                 "0-0:98.1.0(2)(1-0:1.6.0)(1-0:1.6.0)(230201000000W)(230117224500W)(04.329*kW)(230202000000W)(230214224500W)(04529*W)\r\n"
+                                 "1-0:32.32.0(00000)\r\n"
+                                 "1-0:32.36.0(00000)\r\n"
+                                 "0-0:96.13.1()\r\n"
+                                 "0-0:96.13.0()\r\n"
+                                 "1-0:31.7.0(001*A)\r\n"
+                                 "1-0:21.7.0(00.332*kW)\r\n"
+                                 "1-0:22.7.0(00.000*kW)\r\n"
+                                 "0-1:24.1.0(003)\r\n"
+                                 "0-1:96.1.0(0000000000000000000000000000000000)\r\n"
+                                 "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                 "0-1:24.4.0(1)\r\n",
+                                 true), true},
+      {"DSMR 5", finish_telegram("/ISk5\\2MT382-1000\r\n"
+                                 "\r\n"
+                                 "1-3:0.2.8(50)\r\n"
+                                 "0-0:1.0.0(101209113020W)\r\n"
+                                 "0-0:96.1.1(4B384547303034303436333935353037)\r\n"
+                                 "1-0:1.8.1(123456.789*kWh)\r\n"
+                                 "1-0:1.8.2(123456.789*kWh)\r\n"
+                                 "1-0:2.8.1(123456.789*kWh)\r\n"
+                                 "1-0:2.8.2(123456.789*kWh)\r\n"
+                                 "0-0:96.14.0(0002)\r\n"
+                                 "1-0:1.7.0(01.193*kW)\r\n"
+                                 "1-0:2.7.0(00.000*kW)\r\n"
+                                 "0-0:96.7.21(00004)\r\n"
+                                 "0-0:96.7.9(00002)\r\n"
+                                 "1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)(0000000301*s)\r\n"
+                                 "1-0:32.32.0(00002)\r\n"
+                                 "1-0:52.32.0(00001)\r\n"
+                                 "1-0:72.32.0(00000)\r\n"
+                                 "1-0:32.36.0(00000)\r\n"
+                                 "1-0:52.36.0(00003)\r\n"
+                                 "1-0:72.36.0(00000)\r\n"
+                                 "0-0:96.13.0(303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F3031323334353637"
+                                 "38393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F)\r\n"
+                                 "1-0:32.7.0(220.1*V)\r\n"
+                                 "1-0:52.7.0(220.2*V)\r\n"
+                                 "1-0:72.7.0(220.3*V)\r\n"
+                                 "1-0:31.7.0(001*A)\r\n"
+                                 "1-0:51.7.0(002*A)\r\n"
+                                 "1-0:71.7.0(003*A)\r\n"
+                                 "1-0:21.7.0(01.111*kW)\r\n"
+                                 "1-0:41.7.0(02.222*kW)\r\n"
+                                 "1-0:61.7.0(03.333*kW)\r\n"
+                                 "1-0:22.7.0(04.444*kW)\r\n"
+                                 "1-0:42.7.0(05.555*kW)\r\n"
+                                 "1-0:62.7.0(06.666*kW)\r\n"
+                                 "0-1:24.1.0(003)\r\n"
+                                 "0-1:96.1.0(3232323241424344313233343536373839)\r\n"
+                                 "0-1:24.2.1(101209112500W)(12785.123*m3)\r\n",
+                                 true), true},
+      {"Belgium", finish_telegram("/FLU5\\253769484_A\r\n"
+                                  "\r\n"
+                                  "0-0:96.1.4(50217)\r\n"
+                                  "0-0:96.1.1(3153414123456789303132333435)\r\n"
+                                  "0-0:1.0.0(200512135409S)\r\n"
+                                  "1-0:1.8.1(000000.034*kWh)\r\n"
+                                  "1-0:1.8.2(000015.758*kWh)\r\n"
+                                  "1-0:2.8.1(000000.000*kWh)\r\n"
+                                  "1-0:2.8.2(000000.011*kWh)\r\n"
+                                  "1-0:1.4.0(02.351*kW)\r\n"
+                                  "1-0:1.6.0(200509134558S)(02.589*kW)\r\n"
+                                  "0-0:98.1.0(3)(1-0:1.6.0)(1-0:1.6.0)(200501000000S)(200423192538S)(03.695*kW)(200401000000S)(200305122139S)(05.980*kW)"
+                                  "(200301000000S)(200210035421W)(04.318*kW)\r\n"
+                                  "0-0:96.14.0(0001)\r\n"
+                                  "1-0:1.7.0(00.000*kW)\r\n"
+                                  "1-0:2.7.0(00.000*kW)\r\n"
+                                  "1-0:21.7.0(00.000*kW)\r\n"
+                                  "1-0:41.7.0(00.000*kW)\r\n"
+                                  "1-0:61.7.0(00.000*kW)\r\n"
+                                  "1-0:22.7.0(00.000*kW)\r\n"
+                                  "1-0:42.7.0(00.000*kW)\r\n"
+                                  "1-0:62.7.0(00.000*kW)\r\n"
+                                  "1-0:32.7.0(234.7*V)\r\n"
+                                  "1-0:52.7.0(234.7*V)\r\n"
+                                  "1-0:72.7.0(234.7*V)\r\n"
+                                  "1-0:31.7.0(000.00*A)\r\n"
+                                  "1-0:51.7.0(000.00*A)\r\n"
+                                  "1-0:71.7.0(000.00*A)\r\n"
+                                  "0-0:96.3.10(1)\r\n"
+                                  "0-0:17.0.0(999.9*kW)\r\n"
+                                  "1-0:31.4.0(999*A)\r\n"
+                                  "0-0:96.13.0()\r\n"
+                                  "0-1:24.1.0(003)\r\n"
+                                  "0-1:96.1.1(37464C4F32313139303137303532)\r\n"
+                                  "0-1:24.4.0(1)\r\n"
+                                  "0-1:24.2.3(200512134558S)(00112.384*m3)\r\n",
+                                  true), true},
+      {"Luxembourg", finish_telegram("/EST5\\253710000_A\r\n"
+                                     "\r\n"
+                                     "1-3:0.2.8(50)\r\n"
+                                     "0-0:1.0.0(221006155014S)\r\n"
+                                     "1-0:1.8.0(006545766*Wh)\r\n"
+                                     "1-0:1.8.1(005017120*Wh)\r\n"
+                                     "1-0:1.8.2(001528646*Wh)\r\n"
+                                     "1-0:1.7.0(000000286*W)\r\n"
+                                     "1-0:2.8.0(000000058*Wh)\r\n"
+                                     "1-0:2.8.1(000000000*Wh)\r\n"
+                                     "1-0:2.8.2(000000058*Wh)\r\n"
+                                     "1-0:2.7.0(000000000*W)\r\n"
+                                     "1-0:3.8.0(000000747*varh)\r\n"
+                                     "1-0:3.8.1(000000000*varh)\r\n"
+                                     "1-0:3.8.2(000000747*varh)\r\n"
+                                     "1-0:3.7.0(000000000*var)\r\n"
+                                     "1-0:4.8.0(003897726*varh)\r\n"
+                                     "1-0:4.8.1(002692848*varh)\r\n"
+                                     "1-0:4.8.2(001204878*varh)\r\n"
+                                     "1-0:4.7.0(000000166*var)\r\n",
+                                     true), true},
+      {"Switzerland", finish_telegram("/LGZ4ZMF100AC.M23\r\n"
+                                      "\r\n"
+                                      "1-3:0.2.8(50)\r\n"
+                                      "0-0:1.0.0(210204163628W)\r\n"
+                                      "0-0:96.1.1(3835303133313131)\r\n"
+                                      "1-1:1.8.1(002524.380*kWh)\r\n"
+                                      "1-1:1.8.2(003302.557*kWh)\r\n"
+                                      "1-1:2.8.1(000000.000*kWh)\r\n"
+                                      "1-1:2.8.2(000000.000*kWh)\r\n"
+                                      "0-0:96.14.0(0001)\r\n"
+                                      "1-1:1.7.0(00.366*kW)\r\n"
+                                      "1-1:2.7.0(00.000*kW)\r\n"
+                                      "0-0:96.7.21(00003)\r\n"
+                                      "0-0:96.7.9(00001)\r\n"
+                                      "1-0:99.97.0(0)(0-0:96.7.19)\r\n"
+                                      "1-0:32.32.0(00000)\r\n"
+                                      "1-0:32.36.0(00000)\r\n"
+                                      "0-0:96.13.0()\r\n"
+                                      "1-0:32.7.0(230.0*V)\r\n"
+                                      "1-0:52.7.0(231.0*V)\r\n"
+                                      "1-0:72.7.0(229.0*V)\r\n"
+                                      "1-0:31.7.0(001*A)\r\n"
+                                      "1-0:51.7.0(000*A)\r\n"
+                                      "1-0:71.7.0(000*A)\r\n"
+                                      "1-0:21.7.0(00.230*kW)\r\n"
+                                      "1-0:41.7.0(00.090*kW)\r\n"
+                                      "1-0:61.7.0(00.046*kW)\r\n"
+                                      "1-0:22.7.0(00.000*kW)\r\n"
+                                      "1-0:42.7.0(00.000*kW)\r\n"
+                                      "1-0:62.7.0(00.000*kW)\r\n",
+                                      true), true},
+      {"Sweden", finish_telegram("/ELL5\\253833635_A\r\n"
+                                 "\r\n"
+                                 "0-0:1.0.0(210217184019W)\r\n"
+                                 "1-0:1.8.0(00006678.394*kWh)\r\n"
+                                 "1-0:2.8.0(00000000.000*kWh)\r\n"
+                                 "1-0:3.8.0(00000021.988*kvarh)\r\n"
+                                 "1-0:4.8.0(00001020.971*kvarh)\r\n"
+                                 "1-0:1.7.0(0001.727*kW)\r\n"
+                                 "1-0:2.7.0(0000.000*kW)\r\n"
+                                 "1-0:3.7.0(0000.000*kvar)\r\n"
+                                 "1-0:4.7.0(0000.309*kvar)\r\n"
+                                 "1-0:21.7.0(0001.023*kW)\r\n"
+                                 "1-0:41.7.0(0000.350*kW)\r\n"
+                                 "1-0:61.7.0(0000.353*kW)\r\n"
+                                 "1-0:22.7.0(0000.000*kW)\r\n"
+                                 "1-0:42.7.0(0000.000*kW)\r\n"
+                                 "1-0:62.7.0(0000.000*kW)\r\n"
+                                 "1-0:23.7.0(0000.000*kvar)\r\n"
+                                 "1-0:43.7.0(0000.000*kvar)\r\n"
+                                 "1-0:63.7.0(0000.000*kvar)\r\n"
+                                 "1-0:24.7.0(0000.009*kvar)\r\n"
+                                 "1-0:44.7.0(0000.161*kvar)\r\n"
+                                 "1-0:64.7.0(0000.138*kvar)\r\n"
+                                 "1-0:32.7.0(240.3*V)\r\n"
+                                 "1-0:52.7.0(240.1*V)\r\n"
+                                 "1-0:72.7.0(241.3*V)\r\n"
+                                 "1-0:31.7.0(004.2*A)\r\n"
+                                 "1-0:51.7.0(001.6*A)\r\n"
+                                 "1-0:71.7.0(001.7*A)\r\n",
+                                 true), true},
+  };
+  return corpus;
+}
+
+inline const Telegram& telegram(const std::string& name) {
+  for (const auto& t : telegrams())
+    if (t.name == name)
+      return t;
+  return telegrams().front();
+}
+
+}
@@ -0,0 +1,37 @@
+#include "all_fields.h"
+#include "arduino-dsmr-2/time_series.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <cstdint>
+#include <cstdio>
+
+using namespace arduino_dsmr_2;
+using namespace arduino_dsmr_2::fields;
+
+namespace {
+using History = TimeSeries<DefaultTimeSeriesCapacity, energy_delivered_tariff1, energy_delivered_tariff2, power_delivered, power_returned, voltage_l1,
+                           current_l1, power_delivered_l1, gas_delivered>;
+}
+
+// One operation adds a telegram or makes a query. The memory of the store stays the same however many telegrams are added.
+BENCHMARK("TimeSeries") {
+  const auto& telegram = bench::telegram("DSMR 5");
+  bench::AllFields data;
+  P1Parser::parse(&data, telegram.text.data(), telegram.text.size());
+
+  static History history;
+  std::fprintf(bench::report_stream(), "%-60s %zu bytes for 8 fields\n", "TimeSeries/DefaultTimeSeriesCapacity", sizeof(History));
+
+  uint32_t time = 1'700'000'000;
+  bench::measure("TimeSeries::add/8 fields", 0, [&] {
+    ++data.power_delivered._value;
+    bench::do_not_optimize(history.add(time++, data));
+  });
+  bench::measure("TimeSeries quarter hour average and peak", 0, [&] {
+    const auto& quarter = history.series<power_delivered>().quarter_hours().current();
+    bench::do_not_optimize(quarter.average());
+    bench::do_not_optimize(quarter.max);
+  });
+  bench::measure("TimeSeries sliding 15 minutes from the minutes", 0,
+                 [&] { bench::do_not_optimize(history.series<power_delivered>().minutes().last(15).average()); });
+}
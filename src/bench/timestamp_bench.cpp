@@ -0,0 +1,39 @@
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/parser.h"
+#include "bench.h"
+#include "telegrams.h"
+#include <cstddef>
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+namespace typed_fields {
+using namespace arduino_dsmr_2::fields;
+DEFINE_FIELD(timestamp, Timestamp, ObisId(0, 0, 1, 0, 0), TimestampField);
+DEFINE_FIELD(gas_delivered, TypedTimestampedFixedValue, ObisId(0, GAS_MBUS_ID, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+}
+}
+
+// One operation is one timestamp, or one telegram
+BENCHMARK("Timestamp") {
+  const std::string timestamps[] = {"150117185916W", "150118185916W"};
+  bench::measure("TimestampParser::parse/date of the previous timestamp", 13, [&] { bench::do_not_optimize(TimestampParser::parse(timestamps[0])); });
+  size_t index = 0;
+  bench::measure("TimestampParser::parse/another date", 13, [&] {
+    index ^= 1;
+    bench::do_not_optimize(TimestampParser::parse(timestamps[index]));
+  });
+
+  const auto& text = bench::telegram("DSMR 5").text;
+  bench::measure("Timestamps as strings/DSMR 5", static_cast<double>(text.size()), [&] {
+    ParsedData<fields::timestamp, fields::gas_delivered> data;
+    bench::do_not_optimize(P1Parser::parse(&data, text.data(), text.size()));
+    bench::do_not_optimize(data);
+  });
+  bench::measure("Timestamps as Timestamp/DSMR 5", static_cast<double>(text.size()), [&] {
+    ParsedData<typed_fields::timestamp, typed_fields::gas_delivered> data;
+    bench::do_not_optimize(P1Parser::parse(&data, text.data(), text.size()));
+    bench::do_not_optimize(data);
+  });
+}
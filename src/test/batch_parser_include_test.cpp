@@ -0,0 +1,13 @@
+// This code tests that the batch parser has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/batch_parser.h"
+#include "arduino-dsmr-2/fields.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void BatchParser_some_function() {
+  BatchParser<ParsedData<identification, p1_version>> parser({.number_of_threads = 1});
+  parser.parse({}, {}, {});
+}
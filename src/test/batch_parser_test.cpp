@@ -0,0 +1,79 @@
+#include "arduino-dsmr-2/batch_parser.h"
+#include "arduino-dsmr-2/fields.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::telegram;
+
+namespace {
+using Data = ParsedData<identification, energy_delivered_tariff1>;
+
+// Every 7th telegram has a wrong CRC
+std::vector<std::string> archive(const uint32_t size) {
+  std::vector<std::string> telegrams;
+  for (uint32_t i = 0; i < size; ++i) {
+    telegrams.push_back(telegram(i));
+    if (i % 7 == 0) {
+      auto& crc_digit = telegrams.back()[telegrams.back().find('!') + 4];
+      crc_digit = crc_digit == '0' ? '1' : '0';
+    }
+  }
+  return telegrams;
+}
+}
+
+TEST_CASE("P1Parser::parse_batch parses every telegram into its own output") {
+  const auto telegrams = archive(20);
+  const std::vector<std::string_view> views(telegrams.begin(), telegrams.end());
+  std::vector<Data> outputs(views.size());
+  std::vector<ParseResult<void>> results(views.size());
+
+  REQUIRE(P1Parser::parse_batch(std::span(views), std::span(outputs), std::span(results)) == 17);
+  for (uint32_t i = 0; i < views.size(); ++i) {
+    if (i % 7 == 0) {
+      REQUIRE(std::string(results[i].err) == "Checksum mismatch");
+      continue;
+    }
+    REQUIRE(results[i].err == nullptr);
+    REQUIRE(outputs[i].identification == "KFM5KAIFA-METER");
+    REQUIRE(outputs[i].energy_delivered_tariff1.int_val() == i);
+  }
+
+  // The outputs are reset, so they can be reused without "Duplicate field" errors
+  REQUIRE(P1Parser::parse_batch(std::span(views), std::span(outputs), std::span(results)) == 17);
+
+  // Only the telegrams that have an output and a result are parsed
+  REQUIRE(P1Parser::parse_batch(std::span(views), std::span(outputs).first(5), std::span(results)) == 4);
+}
+
+TEST_CASE("BatchParser gives the same results as P1Parser::parse_batch") {
+  const auto telegrams = archive(1000);
+  const std::vector<std::string_view> views(telegrams.begin(), telegrams.end());
+  std::vector<Data> expected_outputs(views.size());
+  std::vector<ParseResult<void>> expected_results(views.size());
+  const auto expected_parsed = P1Parser::parse_batch(std::span(views), std::span(expected_outputs), std::span(expected_results));
+
+  for (const std::size_t number_of_threads : {1u, 2u, 4u}) {
+    BatchParser<Data> parser({.number_of_threads = number_of_threads, .slice_size = 16});
+    std::vector<Data> outputs(views.size());
+    std::vector<ParseResult<void>> results(views.size());
+
+    // Several batches with the same threads, including an empty one
+    for (const std::size_t size : {views.size(), std::size_t{0}, std::size_t{10}, views.size()}) {
+      const auto parsed = parser.parse(std::span(views).first(size), outputs, results);
+      REQUIRE(parsed == (size == views.size() ? expected_parsed : size == 10 ? 8 : 0));
+    }
+
+    for (std::size_t i = 0; i < views.size(); ++i) {
+      REQUIRE(results[i].err == expected_results[i].err);
+      REQUIRE(results[i].next == expected_results[i].next);
+      REQUIRE(outputs[i].identification_present == expected_outputs[i].identification_present);
+      REQUIRE(outputs[i].energy_delivered_tariff1_present == expected_outputs[i].energy_delivered_tariff1_present);
+      REQUIRE(outputs[i].energy_delivered_tariff1.int_val() == expected_outputs[i].energy_delivered_tariff1.int_val());
+    }
+  }
+}
@@ -0,0 +1,14 @@
+// This code tests that the binary serializer has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/binary_serializer.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void BinarySerializer_some_function() {
+  ParsedData<identification, p1_version> data;
+  char buffer[64];
+  BinarySerializer::encode(data, buffer);
+  BinarySerializer::decode(&data, std::span<const char>(buffer));
+}
@@ -0,0 +1,197 @@
+#include "arduino-dsmr-2/binary_serializer.h"
+#include "arduino-dsmr-2/fields.h"
+#include "test_helpers.h"
+#include <array>
+#include <doctest.h>
+#include <string>
+#include <string_view>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::timestamp_text;
+
+namespace {
+using Data = ParsedData<identification, p1_version, timestamp, equipment_id, energy_delivered_tariff1, energy_delivered_tariff2, electricity_tariff,
+                        power_delivered, electricity_switch_position, electricity_failures, gas_delivered, gas_device_type, message_long>;
+
+const auto& msg = "/KFM5KAIFA-METER\r\n"
+                  "\r\n"
+                  "1-3:0.2.8(40)\r\n"
+                  "0-0:1.0.0(150117185916W)\r\n"
+                  "0-0:96.1.1(4530303034303031353934373534343134)\r\n"
+                  "1-0:1.8.1(000671.578*kWh)\r\n"
+                  "1-0:1.8.2(000842.472*kWh)\r\n"
+                  "0-0:96.14.0(0001)\r\n"
+                  "1-0:1.7.0(00.333*kW)\r\n"
+                  "0-0:96.3.10(1)\r\n"
+                  "0-0:96.7.21(00008)\r\n"
+                  "0-1:24.1.0(003)\r\n"
+                  "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                  "!";
+
+// With DSMR_STRING_VIEW_FIELDS the data points into the telegram, so the caller keeps both alive
+void parse(Data* data, const std::string_view telegram) {
+  REQUIRE(P1Parser::parse(data, telegram.data(), telegram.size(), /*unknown_error=*/true, /*check_crc=*/false).err == nullptr);
+}
+
+template <typename T>
+bool same_value(const T& a, const T& b) {
+  return a == b;
+}
+bool same_value(const FixedValue& a, const FixedValue& b) { return a.int_val() == b.int_val(); }
+template <typename String>
+bool same_value(const BasicTimestampedFixedValue<String>& a, const BasicTimestampedFixedValue<String>& b) {
+  return a.int_val() == b.int_val() && a.timestamp == b.timestamp;
+}
+
+// Compares every field of the data with the same field of `other`
+struct Comparer {
+  const Data& other;
+  bool equal = true;
+
+  template <typename Item>
+  void apply(Item& item) {
+    const Item& other_item = other;
+    if (item.present() != other_item.present() || (item.present() && !same_value(item.val(), other_item.val())))
+      equal = false;
+  }
+};
+
+bool equal(Data& a, const Data& b) {
+  Comparer comparer{b};
+  a.applyEach(comparer);
+  return comparer.equal;
+}
+}
+
+TEST_CASE("BinarySerializer decodes the data that it encoded") {
+  Data data;
+  parse(&data, msg);
+  std::array<char, 512> buffer;
+  const auto size = BinarySerializer::encode(data, buffer);
+  REQUIRE(size > 0);
+  REQUIRE(size < std::size(msg) / 2);
+
+  Data decoded;
+  const auto res = BinarySerializer::decode(&decoded, std::span<const char>(buffer).first(size));
+  REQUIRE(res.err == nullptr);
+  REQUIRE(res.next == buffer.data() + size);
+  REQUIRE(equal(decoded, data));
+  REQUIRE(decoded.equipment_id == "4530303034303031353934373534343134");
+  REQUIRE(timestamp_text(decoded.gas_delivered.timestamp) == "150117180000W");
+  REQUIRE(decoded.gas_delivered == 473.789f);
+  REQUIRE(decoded.electricity_switch_position == 1);
+  REQUIRE_FALSE(decoded.message_long_present);
+}
+
+TEST_CASE("BinarySerializer encodes the difference with a reference") {
+  Data previous;
+  parse(&previous, msg);
+  auto next_msg = std::string(msg);
+  next_msg.replace(next_msg.find("000671.578"), 10, "000671.579");
+  next_msg.replace(next_msg.find("00.333"), 6, "00.298");
+  next_msg.replace(next_msg.find("0-1:24.1.0(003)\r\n"), 17, "");
+  Data next;
+  parse(&next, next_msg);
+
+  std::array<char, 512> full;
+  std::array<char, 512> delta;
+  const auto full_size = BinarySerializer::encode(next, full);
+  const auto delta_size = BinarySerializer::encode(next, delta, &previous);
+  REQUIRE(delta_size > 0);
+  // The header, the presence bitmap and one byte for every unchanged or slightly changed value (two for gas_delivered).
+  // A typed timestamp takes one more byte for its summer time flag.
+  REQUIRE(delta_size == 6 + 2 + 12 + (DSMR_TYPED_TIMESTAMPS ? 2 : 0));
+  REQUIRE(delta_size < full_size / 4);
+
+  Data decoded;
+  REQUIRE(BinarySerializer::decode(&decoded, std::span<const char>(delta).first(delta_size), &previous).err == nullptr);
+  REQUIRE(equal(decoded, next));
+  REQUIRE(decoded.energy_delivered_tariff1.int_val() == 671579);
+  REQUIRE(decoded.power_delivered.int_val() == 298);
+  REQUIRE_FALSE(decoded.gas_device_type_present);
+
+  Data without_reference;
+  REQUIRE(std::string(BinarySerializer::decode(&without_reference, std::span<const char>(delta).first(delta_size)).err) == "Reference required");
+}
+
+TEST_CASE("BinarySerializer ignores the values of the fields that are not present in the reference") {
+  Data next;
+  parse(&next, msg);
+  assign_string(next.message_long, "4D657373616765");
+  next.message_long_present = true;
+
+  // The references only differ in the value of a field that is not present, like a reference that was decoded into a reused ParsedData
+  Data reference;
+  parse(&reference, msg);
+  auto decoding_reference = reference;
+  assign_string(reference.message_long, "4D657373616765");
+
+  std::array<char, 512> buffer;
+  const auto size = BinarySerializer::encode(next, buffer, &reference);
+  Data decoded;
+  REQUIRE(BinarySerializer::decode(&decoded, std::span<const char>(buffer).first(size), &decoding_reference).err == nullptr);
+  REQUIRE(equal(decoded, next));
+}
+
+TEST_CASE("BinarySerializer reads records one after another") {
+  Data data;
+  parse(&data, msg);
+  std::array<char, 1024> log;
+  const auto first = BinarySerializer::encode(data, log);
+  const auto second = BinarySerializer::encode(data, std::span(log).subspan(first), &data);
+  REQUIRE(first > 0);
+  REQUIRE(second > 0);
+
+  const auto records = std::span<const char>(log).first(first + second);
+  Data first_record;
+  const auto res = BinarySerializer::decode(&first_record, records);
+  REQUIRE(res.err == nullptr);
+  Data second_record;
+  const auto rest = records.subspan(static_cast<size_t>(res.next - records.data()));
+  REQUIRE(BinarySerializer::decode(&second_record, rest, &first_record).next == records.data() + records.size());
+  REQUIRE(equal(second_record, data));
+}
+
+TEST_CASE("BinarySerializer reports errors") {
+  Data data;
+  parse(&data, msg);
+  std::array<char, 512> buffer;
+  const auto size = BinarySerializer::encode(data, buffer);
+
+  // The buffer is too small
+  std::array<char, 20> small;
+  REQUIRE(BinarySerializer::encode(data, small) == 0);
+
+  // Truncated record
+  for (size_t truncated_size = 0; truncated_size < size; ++truncated_size) {
+    Data decoded;
+    const auto err = BinarySerializer::decode(&decoded, std::span<const char>(buffer).first(truncated_size)).err;
+    REQUIRE(err != nullptr);
+  }
+
+  // Another ParsedData
+  ParsedData<identification, p1_version> other;
+  REQUIRE(std::string(BinarySerializer::decode(&other, std::span<const char>(buffer).first(size)).err) == "Schema mismatch");
+
+  // Another format version
+  buffer[0] = 2;
+  Data decoded;
+  REQUIRE(std::string(BinarySerializer::decode(&decoded, std::span<const char>(buffer).first(size)).err) == "Unsupported format version");
+}
+
+namespace small_fields {
+DEFINE_FIELD(identification, FixedString<4>, ObisId(255, 255, 255, 255, 255, 255), RawField);
+}
+
+TEST_CASE("BinarySerializer checks the capacity of a FixedString") {
+  ParsedData<identification> data;
+  data.identification = "KFM5KAIFA-METER";
+  data.identification_present = true;
+  std::array<char, 64> buffer;
+  const auto size = BinarySerializer::encode(data, buffer);
+
+  // The same field, but the value only fits 4 characters
+  ParsedData<small_fields::identification> decoded;
+  REQUIRE(std::string(BinarySerializer::decode(&decoded, std::span<const char>(buffer).first(size)).err) == "Invalid string length");
+}
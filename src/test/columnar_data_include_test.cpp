@@ -0,0 +1,13 @@
+// This code tests that the columnar data has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/columnar_data.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void ColumnarData_some_function() {
+  ColumnarData<identification, power_delivered> data(1);
+  auto row = data.row(0);
+  P1Parser::parse(&row, "", 0);
+}
@@ -0,0 +1,129 @@
+#include "arduino-dsmr-2/columnar_data.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <string>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::timestamp_text;
+
+namespace {
+const auto& msg1 = "/KFM5KAIFA-METER\r\n"
+                   "\r\n"
+                   "0-0:96.1.1(4530303034303031353934373534343134)\r\n"
+                   "1-0:1.8.1(000671.578*kWh)\r\n"
+                   "1-0:1.7.0(00.333*kW)\r\n"
+                   "0-0:96.7.21(00008)\r\n"
+                   "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                   "!";
+
+const auto& msg2 = "/KFM5KAIFA-METER\r\n"
+                   "\r\n"
+                   "0-0:96.1.1(4530303034303031353934373534343134)\r\n"
+                   "1-0:1.8.1(000672.000*kWh)\r\n"
+                   "!";
+
+const auto& msg3 = "/ISk5\\2MT382-1000\r\n"
+                   "\r\n"
+                   "0-0:96.1.1(4B384547303034303436333935353037)\r\n"
+                   "1-0:1.7.0(01.193*kW)\r\n"
+                   "!";
+
+using Data = ColumnarData<identification, equipment_id, energy_delivered_tariff1, power_delivered, electricity_failures, gas_delivered>;
+}
+
+TEST_CASE("ColumnarData stores every telegram in a row") {
+  Data data(3);
+  REQUIRE(data.size() == 3);
+  for (const auto& [index, msg, size] : {std::tuple{0u, msg1, std::size(msg1)}, {1u, msg2, std::size(msg2)}, {2u, msg3, std::size(msg3)}}) {
+    auto row = data.row(index);
+    REQUIRE(P1Parser::parse(&row, msg, size, /*unknown_error=*/false, /*check_crc=*/false).err == nullptr);
+  }
+
+  const auto& energy = data.column<energy_delivered_tariff1>();
+  REQUIRE(energy.values().size() == 3);
+  REQUIRE(energy[0] == 671578);
+  REQUIRE(energy[1] == 672000);
+  REQUIRE(energy.present(1));
+  REQUIRE_FALSE(energy.present(2));
+  REQUIRE(energy[2] == 0);
+
+  const auto& power = data.column<power_delivered>();
+  REQUIRE(power.presence().words().size() == 1);
+  REQUIRE(power.presence().words()[0] == 0b101);
+  REQUIRE(power[0] == 333);
+  REQUIRE(power[2] == 1193);
+
+  const auto& failures = data.column<electricity_failures>();
+  REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(failures.values())>, std::span<const uint32_t>>);
+  REQUIRE(failures[0] == 8);
+
+  const auto& gas = data.column<gas_delivered>();
+  REQUIRE(gas[0] == 473.789f);
+  REQUIRE(timestamp_text(gas[0].timestamp) == "150117180000W");
+  REQUIRE_FALSE(gas.present(1));
+}
+
+TEST_CASE("ColumnarData stores every distinct string once") {
+  Data data(3);
+  for (const auto& [index, msg, size] : {std::tuple{0u, msg1, std::size(msg1)}, {1u, msg2, std::size(msg2)}, {2u, msg3, std::size(msg3)}}) {
+    auto row = data.row(index);
+    REQUIRE(P1Parser::parse(&row, msg, size, /*unknown_error=*/false, /*check_crc=*/false).err == nullptr);
+  }
+
+  const auto& ids = data.column<equipment_id>();
+  REQUIRE(ids.dictionary().size() == 2);
+  REQUIRE(ids.codes()[0] == ids.codes()[1]);
+  REQUIRE(ids.codes()[2] != ids.codes()[0]);
+  REQUIRE(ids[0] == "4530303034303031353934373534343134");
+  REQUIRE(ids[2] == "4B384547303034303436333935353037");
+
+  const auto& identifications = data.column<identification>();
+  REQUIRE(identifications.dictionary().size() == 2);
+  REQUIRE(identifications[1] == "KFM5KAIFA-METER");
+  REQUIRE(identifications[2] == "ISk5\\2MT382-1000");
+
+  // The dictionary is kept when the rows are cleared
+  data.clear();
+  data.resize(1);
+  REQUIRE_FALSE(ids.present(0));
+  auto row = data.row(0);
+  REQUIRE(P1Parser::parse(&row, msg3, std::size(msg3), /*unknown_error=*/false, /*check_crc=*/false).err == nullptr);
+  REQUIRE(ids.dictionary().size() == 2);
+  REQUIRE(ids[0] == "4B384547303034303436333935353037");
+}
+
+TEST_CASE("ColumnarData reports the same errors as ParsedData") {
+  const auto& duplicate = "/AAA5MTR\r\n"
+                          "\r\n"
+                          "1-0:1.7.0(00.123*kW)\r\n"
+                          "1-0:1.7.0(00.456*kW)\r\n"
+                          "!";
+  Data data(1);
+  auto row = data.row(0);
+  REQUIRE(std::string(P1Parser::parse(&row, duplicate, std::size(duplicate), /*unknown_error=*/false, /*check_crc=*/false).err) == "Duplicate field");
+  REQUIRE(data.column<power_delivered>()[0] == 123);
+
+  const auto& unknown = "/AAA5MTR\r\n"
+                        "\r\n"
+                        "1-0:2.7.0(00.123*kW)\r\n"
+                        "!";
+  data.clear();
+  data.resize(1);
+  row = data.row(0);
+  REQUIRE(std::string(P1Parser::parse(&row, unknown, std::size(unknown), /*unknown_error=*/true, /*check_crc=*/false).err) == "Unknown field");
+}
+
+TEST_CASE("PresenceBitmap clears the bits of removed rows") {
+  PresenceBitmap bitmap;
+  bitmap.resize(70);
+  bitmap.set(3);
+  bitmap.set(65);
+  bitmap.set(69);
+  bitmap.resize(66);
+  REQUIRE(bitmap.words()[1] == 0b10);
+  bitmap.resize(70);
+  REQUIRE(bitmap.test(65));
+  REQUIRE_FALSE(bitmap.test(69));
+  REQUIRE(bitmap.test(3));
+}
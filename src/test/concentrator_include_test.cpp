@@ -0,0 +1,13 @@
+// This code tests that the concentrator has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/concentrator.h"
+#include "arduino-dsmr-2/fields.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void Concentrator_some_function() {
+  Concentrator<ParsedData<energy_delivered_tariff1, power_delivered>> concentrator({.number_of_streams = 1});
+  concentrator.push(0, std::span<const char>());
+}
@@ -0,0 +1,209 @@
+#include "arduino-dsmr-2/concentrator.h"
+#include "arduino-dsmr-2/fields.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::telegram;
+
+// The Concentrator reuses the packet buffers before the results are used, so it doesn't support std::string_view fields
+#if !DSMR_STRING_VIEW_FIELDS
+
+namespace {
+using Data = ParsedData<identification, energy_delivered_tariff1>;
+using TestConcentrator = Concentrator<Data>;
+
+std::vector<TestConcentrator::Result> pop_all(TestConcentrator& concentrator) {
+  concentrator.close();
+  std::vector<TestConcentrator::Result> results;
+  while (auto res = concentrator.pop())
+    results.push_back(std::move(*res));
+  return results;
+}
+}
+
+TEST_CASE("Concentrator parses interleaved streams") {
+  constexpr size_t number_of_streams = 50;
+  constexpr uint32_t packets_per_stream = 20;
+  TestConcentrator concentrator({.number_of_streams = number_of_streams, .number_of_workers = 3, .buffer_size = 200});
+
+  // Every stream sends its packets in chunks of a different size, the chunks of all streams are interleaved
+  std::vector<std::string> streams(number_of_streams);
+  for (size_t s = 0; s < number_of_streams; ++s) {
+    for (uint32_t i = 0; i < packets_per_stream; ++i)
+      streams[s] += "garbage" + telegram(static_cast<uint32_t>(s * 1000 + i));
+  }
+
+  std::vector<size_t> positions(number_of_streams);
+  for (bool done = false; !done;) {
+    done = true;
+    for (size_t s = 0; s < number_of_streams; ++s) {
+      const auto chunk_size = std::min(s % 17 + 1, streams[s].size() - positions[s]);
+      if (chunk_size == 0)
+        continue;
+      REQUIRE(concentrator.push(s, std::string_view(streams[s]).substr(positions[s], chunk_size)));
+      positions[s] += chunk_size;
+      done = false;
+    }
+  }
+
+  const auto results = pop_all(concentrator);
+  REQUIRE(results.size() == number_of_streams * packets_per_stream);
+
+  // The packets of every stream arrive in order
+  std::map<size_t, uint32_t> next_packet;
+  for (const auto& res : results) {
+    REQUIRE(!res.error);
+    REQUIRE(res.data.identification == "KFM5KAIFA-METER");
+    REQUIRE(res.data.energy_delivered_tariff1.int_val() == res.stream_id * 1000 + next_packet[res.stream_id]++);
+  }
+  for (size_t s = 0; s < number_of_streams; ++s)
+    REQUIRE(next_packet[s] == packets_per_stream);
+}
+
+TEST_CASE("Concentrator reports framing and parsing errors") {
+  TestConcentrator concentrator({.number_of_streams = 4, .number_of_workers = 2, .buffer_size = 100});
+  auto corrupted = telegram(1);
+  corrupted[3] = 'X';
+
+  REQUIRE(concentrator.push(0, telegram(1).substr(0, 20) + telegram(2)));
+  REQUIRE(concentrator.push(1, "/" + std::string(200, 'a') + "!0000" + telegram(3)));
+  REQUIRE(concentrator.push(2, corrupted + telegram(4)));
+  REQUIRE(concentrator.push(3, telegram(5).substr(0, 30) + "/" + telegram(6).substr(1)));
+  REQUIRE(!concentrator.push(4, telegram(7)));
+
+  std::map<size_t, std::vector<TestConcentrator::Result>> results;
+  for (auto& res : pop_all(concentrator))
+    results[res.stream_id].push_back(std::move(res));
+
+  REQUIRE(results[0].size() == 2);
+  REQUIRE(results[0][0].error == ConcentratorError::PacketStartSymbolInPacket);
+  REQUIRE(results[0][1].data.energy_delivered_tariff1.int_val() == 2);
+
+  REQUIRE(results[1].size() == 2);
+  REQUIRE(results[1][0].error == ConcentratorError::BufferOverflow);
+  REQUIRE(results[1][1].data.energy_delivered_tariff1.int_val() == 3);
+
+  REQUIRE(results[2].size() == 2);
+  REQUIRE(results[2][0].error == ConcentratorError::ParseError);
+  REQUIRE(std::string(results[2][0].parse_error) == "Checksum mismatch");
+  REQUIRE(!results[2][1].error);
+
+  REQUIRE(results[3].size() == 2);
+  REQUIRE(results[3][0].error == ConcentratorError::PacketStartSymbolInPacket);
+  REQUIRE(results[3][1].data.energy_delivered_tariff1.int_val() == 6);
+}
+
+TEST_CASE("Concentrator checks the CRC symbols") {
+  TestConcentrator concentrator({.number_of_streams = 2, .number_of_workers = 1, .buffer_size = 100});
+  auto corrupted = telegram(1);
+  corrupted[corrupted.size() - 5] = 'X';
+  auto without_crc = telegram(2);
+  without_crc.resize(without_crc.size() - 6); // drops the CRC and the line break after '!'
+
+  REQUIRE(concentrator.push(0, corrupted + telegram(3)));
+  REQUIRE(concentrator.push(1, without_crc + "\r\n" + telegram(4)));
+
+  std::map<size_t, std::vector<TestConcentrator::Result>> results;
+  for (auto& res : pop_all(concentrator))
+    results[res.stream_id].push_back(std::move(res));
+
+  REQUIRE(results[0].size() == 2);
+  REQUIRE(results[0][0].error == ConcentratorError::IncorrectCrcCharacter);
+  REQUIRE(results[0][1].data.energy_delivered_tariff1.int_val() == 3);
+
+  REQUIRE(results[1].size() == 2);
+  REQUIRE(results[1][0].error == ConcentratorError::IncorrectCrcCharacter);
+  REQUIRE(results[1][1].data.energy_delivered_tariff1.int_val() == 4);
+}
+
+TEST_CASE("Concentrator drops packets when all buffers are in use") {
+  TestConcentrator concentrator({.number_of_streams = 3, .number_of_workers = 1, .buffer_size = 100, .buffers_per_worker = 2});
+  const auto packet = telegram(1);
+
+  // Streams 0 and 1 hold the two buffers until their packets are complete
+  REQUIRE(concentrator.push(0, packet.substr(0, 10)));
+  REQUIRE(concentrator.push(1, packet.substr(0, 10)));
+  REQUIRE(concentrator.push(2, packet));
+  REQUIRE(concentrator.push(0, packet.substr(10)));
+  REQUIRE(concentrator.push(2, packet));
+  REQUIRE(concentrator.push(1, packet.substr(10)));
+
+  std::map<size_t, std::vector<TestConcentrator::Result>> results;
+  for (auto& res : pop_all(concentrator))
+    results[res.stream_id].push_back(std::move(res));
+
+  REQUIRE(results[0].size() == 1);
+  REQUIRE(!results[0][0].error);
+  REQUIRE(results[1].size() == 1);
+  REQUIRE(!results[1][0].error);
+  REQUIRE(results[2].size() == 2);
+  REQUIRE(results[2][0].error == ConcentratorError::NoFreeBuffer);
+  REQUIRE(!results[2][1].error);
+}
+
+TEST_CASE("Concentrator applies backpressure with bounded queues") {
+  constexpr size_t number_of_packets = 500;
+  TestConcentrator concentrator(
+      {.number_of_streams = 8, .number_of_workers = 2, .buffer_size = 200, .result_queue_capacity = 4, .max_pending_bytes_per_worker = 256});
+
+  std::thread producer([&] {
+    for (size_t i = 0; i < number_of_packets; ++i)
+      REQUIRE(concentrator.push(i % 8, telegram(static_cast<uint32_t>(i))));
+    concentrator.close();
+  });
+
+  size_t received = 0;
+  while (const auto res = concentrator.pop()) {
+    REQUIRE(!res->error);
+    REQUIRE(res->data.energy_delivered_tariff1.int_val() % 8 == res->stream_id);
+    ++received;
+  }
+  producer.join();
+  REQUIRE(received == number_of_packets);
+  REQUIRE(!concentrator.push(0, telegram(1)));
+}
+
+TEST_CASE("Concentrator can be used by one thread with try_push") {
+  constexpr uint32_t number_of_packets = 100;
+  TestConcentrator concentrator({.number_of_streams = 2, .number_of_workers = 1, .result_queue_capacity = 1, .max_pending_bytes_per_worker = 256});
+
+  uint32_t received = 0;
+  const auto take_results = [&] {
+    while (const auto res = concentrator.try_pop()) {
+      REQUIRE(!res->error);
+      REQUIRE(res->data.energy_delivered_tariff1.int_val() == received++);
+    }
+  };
+
+  for (uint32_t i = 0; i < number_of_packets; ++i) {
+    while (!concentrator.try_push(0, telegram(i))) {
+      take_results();
+      std::this_thread::yield();
+    }
+  }
+  REQUIRE(!concentrator.try_push(2, telegram(1)));
+
+  concentrator.close();
+  REQUIRE(!concentrator.try_push(0, telegram(1)));
+  while (const auto res = concentrator.pop())
+    REQUIRE(res->data.energy_delivered_tariff1.int_val() == received++);
+  REQUIRE(received == number_of_packets);
+}
+
+TEST_CASE("Concentrator can be destroyed while the result queue is full") {
+  TestConcentrator concentrator({.number_of_streams = 2, .number_of_workers = 2, .result_queue_capacity = 1});
+  for (uint32_t i = 0; i < 10; ++i)
+    REQUIRE(concentrator.push(i % 2, telegram(i)));
+
+  const auto res = concentrator.pop();
+  REQUIRE(res);
+  REQUIRE(!res->error);
+}
+
+#endif
@@ -0,0 +1,6 @@
+// This code tests that the crc16 header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/crc16.h"
+
+uint16_t Crc16_some_function() { return arduino_dsmr_2::Crc16::update(0, "", 0); }
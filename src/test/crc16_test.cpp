@@ -0,0 +1,48 @@
+#include "arduino-dsmr-2/crc16.h"
+#include <doctest.h>
+#include <string>
+
+using namespace arduino_dsmr_2;
+
+template <typename Implementation>
+static uint16_t crc_byte_by_byte(const std::string& data) {
+  uint16_t crc = 0;
+  for (const auto& byte : data)
+    crc = Implementation::update(crc, static_cast<uint8_t>(byte));
+  return crc;
+}
+
+template <typename Implementation>
+static uint16_t crc_of_buffer(const std::string& data) {
+  return Implementation::update(0, data.data(), data.size());
+}
+
+TEST_CASE("All CRC16 implementations produce the CRC16/ARC check value") {
+  const std::string check_string = "123456789";
+  REQUIRE(crc_of_buffer<Crc16Bitwise>(check_string) == 0xBB3D);
+  REQUIRE(crc_of_buffer<Crc16Table>(check_string) == 0xBB3D);
+  REQUIRE(crc_of_buffer<Crc16SlicingBy4>(check_string) == 0xBB3D);
+  REQUIRE(crc_of_buffer<Crc16SlicingBy8>(check_string) == 0xBB3D);
+  REQUIRE(crc_of_buffer<Crc16Clmul>(check_string) == 0xBB3D);
+  REQUIRE(crc_byte_by_byte<Crc16>(check_string) == 0xBB3D);
+}
+
+TEST_CASE("All CRC16 implementations give the same result for any length and continuation") {
+  std::string data;
+  for (std::size_t i = 0; i < 256; ++i) {
+    // 37 is odd, so the 256 bytes take all possible values, including the ones with the highest bit set
+    data += static_cast<char>((i * 37 + 11) & 0xFF);
+
+    const auto& expected = crc_byte_by_byte<Crc16Bitwise>(data);
+    REQUIRE(crc_byte_by_byte<Crc16Table>(data) == expected);
+    REQUIRE(crc_of_buffer<Crc16Table>(data) == expected);
+    REQUIRE(crc_of_buffer<Crc16SlicingBy4>(data) == expected);
+    REQUIRE(crc_of_buffer<Crc16SlicingBy8>(data) == expected);
+    REQUIRE(crc_of_buffer<Crc16Clmul>(data) == expected);
+
+    // The CRC can be calculated in several steps
+    const auto& half = data.size() / 2;
+    REQUIRE(Crc16SlicingBy8::update(Crc16SlicingBy8::update(0, data.data(), half), data.data() + half, data.size() - half) == expected);
+    REQUIRE(Crc16Clmul::update(Crc16Clmul::update(0, data.data(), half), data.data() + half, data.size() - half) == expected);
+  }
+}
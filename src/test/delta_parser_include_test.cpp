@@ -0,0 +1,13 @@
+// This code tests that the delta parser has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/delta_parser.h"
+#include "arduino-dsmr-2/fields.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void DeltaParser_some_function() {
+  DeltaParser<ParsedData<energy_delivered_tariff1, power_delivered>> parser;
+  parser.parse("", 0);
+}
@@ -0,0 +1,126 @@
+#include "arduino-dsmr-2/delta_parser.h"
+#include "arduino-dsmr-2/fields.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::timestamp_text;
+using test_helpers::with_crc;
+
+// DeltaParser keeps the values of the fields between telegrams, so it doesn't support std::string_view fields
+#if !DSMR_STRING_VIEW_FIELDS
+
+namespace {
+using Data = ParsedData<identification, equipment_id, energy_delivered_tariff1, power_delivered, gas_delivered>;
+
+std::string telegram(const std::string& lines) { return with_crc("/KFM5KAIFA-METER\r\n\r\n" + lines + "!"); }
+
+const std::string equipment_id_line = "0-0:96.1.1(4530303034303031353934373534343134)\r\n";
+const std::string energy_line = "1-0:1.8.1(000671.578*kWh)\r\n";
+const std::string gas_line = "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n";
+
+struct NameCollector {
+  std::vector<std::string> names;
+
+  template <typename Item>
+  void apply(Item&) {
+    names.push_back(Item::name);
+  }
+};
+
+std::vector<std::string> changed_names(DeltaParser<Data>& parser) {
+  NameCollector collector;
+  parser.apply_changed(collector);
+  return collector.names;
+}
+}
+
+TEST_CASE("DeltaParser only reports the fields that changed") {
+  DeltaParser<Data> parser;
+
+  const auto first = telegram(equipment_id_line + energy_line + "1-0:1.7.0(00.333*kW)\r\n" + gas_line);
+  REQUIRE(parser.parse(first.data(), first.size()).err == nullptr);
+  REQUIRE(parser.changed_fields().all());
+  REQUIRE(parser.data().power_delivered == 0.333f);
+
+  // Only the power changed
+  const auto second = telegram(equipment_id_line + energy_line + "1-0:1.7.0(00.456*kW)\r\n" + gas_line);
+  REQUIRE(parser.parse(second.data(), second.size()).err == nullptr);
+  REQUIRE(changed_names(parser) == std::vector<std::string>{"power_delivered"});
+  REQUIRE(parser.changed<power_delivered>());
+  REQUIRE_FALSE(parser.changed<energy_delivered_tariff1>());
+  REQUIRE(parser.data().power_delivered == 0.456f);
+  REQUIRE(parser.data().energy_delivered_tariff1 == 671.578f);
+  REQUIRE(parser.data().equipment_id == "4530303034303031353934373534343134");
+  REQUIRE(timestamp_text(parser.data().gas_delivered.timestamp) == "150117180000W");
+
+  // The same telegram again: nothing changed
+  REQUIRE(parser.parse(second.data(), second.size()).err == nullptr);
+  REQUIRE(parser.changed_fields().none());
+  REQUIRE(parser.data().power_delivered == 0.456f);
+}
+
+TEST_CASE("DeltaParser reports the fields that appear and disappear") {
+  DeltaParser<Data> parser;
+
+  const auto with_gas = telegram(energy_line + gas_line);
+  const auto without_gas = telegram(energy_line + "1-0:1.7.0(00.333*kW)\r\n");
+  REQUIRE(parser.parse(with_gas.data(), with_gas.size()).err == nullptr);
+
+  REQUIRE(parser.parse(without_gas.data(), without_gas.size()).err == nullptr);
+  REQUIRE(changed_names(parser) == std::vector<std::string>{"power_delivered", "gas_delivered"});
+  REQUIRE_FALSE(parser.data().gas_delivered_present);
+  REQUIRE(parser.data().power_delivered_present);
+
+  REQUIRE(parser.parse(with_gas.data(), with_gas.size()).err == nullptr);
+  REQUIRE(changed_names(parser) == std::vector<std::string>{"power_delivered", "gas_delivered"});
+  REQUIRE(parser.data().gas_delivered == 473.789f);
+  REQUIRE_FALSE(parser.data().power_delivered_present);
+}
+
+TEST_CASE("DeltaParser gives the same data as P1Parser::parse") {
+  const std::vector<std::string> telegrams = {
+      telegram(equipment_id_line + energy_line + "1-0:1.7.0(00.333*kW)\r\n"),
+      telegram(equipment_id_line + "1-0:1.8.1(000671.579*kWh)\r\n" + "1-0:1.7.0(00.333*kW)\r\n"),
+      telegram("1-0:1.7.0(00.333*kW)\r\n" + equipment_id_line + "1-0:1.8.1(000671.579*kWh)\r\n"),
+      telegram(equipment_id_line + "1-0:1.8.1(000671.579*kWh)\r\n"),
+  };
+
+  DeltaParser<Data> parser;
+  for (const auto& t : telegrams) {
+    Data expected;
+    REQUIRE(P1Parser::parse(&expected, t.data(), t.size()).err == nullptr);
+    REQUIRE(parser.parse(t.data(), t.size()).err == nullptr);
+    REQUIRE(parser.data().identification == expected.identification);
+    REQUIRE(parser.data().equipment_id == expected.equipment_id);
+    REQUIRE(parser.data().energy_delivered_tariff1_present == expected.energy_delivered_tariff1_present);
+    REQUIRE(parser.data().energy_delivered_tariff1.int_val() == expected.energy_delivered_tariff1.int_val());
+    REQUIRE(parser.data().power_delivered_present == expected.power_delivered_present);
+    REQUIRE(parser.data().gas_delivered_present == expected.gas_delivered_present);
+  }
+}
+
+TEST_CASE("DeltaParser parses the next telegram completely after an error") {
+  DeltaParser<Data> parser;
+  const auto good = telegram(energy_line);
+  REQUIRE(parser.parse(good.data(), good.size()).err == nullptr);
+
+  auto corrupted = good;
+  auto& crc_digit = corrupted[corrupted.find('!') + 4];
+  crc_digit = crc_digit == '0' ? '1' : '0';
+  REQUIRE(std::string(parser.parse(corrupted.data(), corrupted.size()).err) == "Checksum mismatch");
+  REQUIRE_FALSE(parser.data().energy_delivered_tariff1_present);
+
+  REQUIRE(parser.parse(good.data(), good.size()).err == nullptr);
+  REQUIRE(parser.changed<energy_delivered_tariff1>());
+  REQUIRE(parser.data().energy_delivered_tariff1 == 671.578f);
+
+  const auto duplicate = telegram(energy_line + energy_line);
+  REQUIRE(std::string(parser.parse(duplicate.data(), duplicate.size()).err) == "Duplicate field");
+  REQUIRE_FALSE(parser.data().energy_delivered_tariff1_present);
+}
+
+#endif
@@ -22,6 +22,8 @@ TEST_CASE("EncryptedPacketAccumulator example") {
   // Use this class only if you have a smart meter that uses encryption.
   // You only need to create this class once.
   EncryptedPacketAccumulator accumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  // Alternatively, the accumulator can decrypt the packet in place while it is received. It then needs only one buffer for the telegram:
+  //   EncryptedPacketAccumulator accumulator(decrypted_packet_buffer);
 
   // Set the encryption key. This key is unique for each smart meter and should be provided by your energy supplier.
   const auto error = accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA");
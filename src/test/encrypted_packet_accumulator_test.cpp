@@ -82,6 +82,56 @@ TEST_CASE("Encryption key validation") {
           EncryptedPacketAccumulator::SetEncryptionKeyError::EncryptionKeyContainsNonHexSymbols);
 }
 
+TEST_CASE("An invalid key doesn't replace the current key") {
+  std::array<std::uint8_t, 2000> encrypted_packet_buffer;
+  std::array<char, 2000> decrypted_packet_buffer;
+
+  auto accumulator = EncryptedPacketAccumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+  REQUIRE(accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAG").has_value());
+
+  std::size_t packets = 0;
+  for (const auto& byte : encrypted_packet) {
+    const auto& res = accumulator.process_byte(byte);
+    REQUIRE_FALSE(res.error());
+    packets += res.packet().has_value();
+  }
+  REQUIRE(packets == 1);
+}
+
+TEST_CASE("The encryption key is kept when the accumulator is moved") {
+  std::array<std::uint8_t, 2000> encrypted_packet_buffer;
+  std::array<char, 2000> decrypted_packet_buffer;
+
+  auto accumulator = EncryptedPacketAccumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+
+  auto moved_accumulator = std::move(accumulator);
+  auto move_assigned_accumulator = EncryptedPacketAccumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  move_assigned_accumulator = std::move(moved_accumulator);
+
+  std::size_t packets = 0;
+  for (const auto& byte : concat(encrypted_packet, encrypted_packet)) {
+    const auto& res = move_assigned_accumulator.process_byte(byte);
+    REQUIRE_FALSE(res.error());
+    packets += res.packet().has_value();
+  }
+  REQUIRE(packets == 2);
+}
+
+TEST_CASE("A new accumulator decrypts with an all-zero key") {
+  std::array<std::uint8_t, 2000> encrypted_packet_buffer;
+  std::array<char, 2000> decrypted_packet_buffer;
+
+  auto accumulator = EncryptedPacketAccumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+  std::vector<EncryptedPacketAccumulator::Error> errors;
+  for (const auto& byte : encrypted_packet) {
+    if (const auto& res = accumulator.process_byte(byte); res.error())
+      errors.push_back(*res.error());
+  }
+  REQUIRE(errors == std::vector{EncryptedPacketAccumulator::Error::DecryptionFailed});
+}
+
 TEST_CASE("BufferOverflow when telegram length exceeds capacity") {
   std::array<std::uint8_t, 10> encrypted_packet_buffer;
   std::array<char, 10> decrypted_packet_buffer;
@@ -155,3 +205,127 @@ TEST_CASE("Receive many packets") {
   REQUIRE(occurred_errors == std::vector{HeaderCorrupted, HeaderCorrupted, HeaderCorrupted, HeaderCorrupted, DecryptionFailed, DecryptionFailed, BufferOverflow,
                                          HeaderCorrupted, HeaderCorrupted, HeaderCorrupted});
 }
+
+TEST_CASE("In-place decryption needs a buffer only for the telegram") {
+  const auto telegram_length = encrypted_packet.size() - 18 - 12;
+
+  SUBCASE("Buffer fits the telegram") {
+    std::vector<char> buffer(telegram_length);
+    auto accumulator = EncryptedPacketAccumulator(buffer);
+    REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+
+    std::vector<std::string> packets;
+    for (const auto& byte : encrypted_packet) {
+      const auto& res = accumulator.process_byte(byte);
+      REQUIRE_FALSE(res.error());
+      if (res.packet())
+        packets.emplace_back(*res.packet());
+    }
+    REQUIRE(packets.size() == 1);
+    REQUIRE(packets[0].starts_with("/EST5\\253710000_A\r\n"));
+    REQUIRE(packets[0].ends_with("1-0:4.7.0(000000166*var)\r\n!7EF9\r\n"));
+  }
+
+  SUBCASE("Buffer is one byte too small") {
+    std::vector<char> buffer(telegram_length - 1);
+    auto accumulator = EncryptedPacketAccumulator(buffer);
+    std::vector<EncryptedPacketAccumulator::Error> errors;
+    for (const auto& byte : encrypted_packet) {
+      if (const auto& res = accumulator.process_byte(byte); res.error())
+        errors.push_back(*res.error());
+    }
+    // The rest of the packet is skipped as garbage
+    REQUIRE(!errors.empty());
+    REQUIRE(errors[0] == EncryptedPacketAccumulator::Error::BufferOverflow);
+  }
+}
+
+TEST_CASE("In-place decryption wipes the buffer if authentication fails") {
+  for (const auto& corrupted_byte : {std::size_t(50), encrypted_packet.size() - 1}) { // ciphertext and GCM tag
+    std::vector<char> buffer(1000, 'x');
+    auto accumulator = EncryptedPacketAccumulator(buffer);
+    REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+
+    auto corrupted_packet = encrypted_packet;
+    corrupted_packet[corrupted_byte] ^= 0xFF;
+
+    std::vector<EncryptedPacketAccumulator::Error> errors;
+    for (const auto& byte : corrupted_packet) {
+      const auto& res = accumulator.process_byte(byte);
+      REQUIRE_FALSE(res.packet());
+      if (res.error())
+        errors.push_back(*res.error());
+    }
+    REQUIRE(errors == std::vector{EncryptedPacketAccumulator::Error::DecryptionFailed});
+    REQUIRE(std::all_of(buffer.begin(), buffer.end(), [](const char c) { return c == 0; }));
+  }
+}
+
+TEST_CASE("In-place decryption wipes the buffer if the packet is reset halfway") {
+  std::vector<char> buffer(1000, 'x');
+  auto accumulator = EncryptedPacketAccumulator(buffer);
+  REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+
+  // The packet is cut off after the header and half of the telegram, which are decrypted in blocks of 16 bytes
+  const auto cut_off = encrypted_packet.size() / 2;
+  for (std::size_t i = 0; i < cut_off; ++i)
+    REQUIRE_FALSE(accumulator.process_byte(encrypted_packet[i]).packet());
+  const auto decrypted = (cut_off - 18) / 16 * 16;
+  REQUIRE(std::string_view(buffer.data(), 5) == "/EST5");
+
+  accumulator.reset();
+  REQUIRE(std::all_of(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(decrypted), [](const char c) { return c == 0; }));
+
+  // The next packet is received completely
+  std::vector<std::string> packets;
+  for (const auto& byte : encrypted_packet) {
+    const auto& res = accumulator.process_byte(byte);
+    REQUIRE_FALSE(res.error());
+    if (res.packet())
+      packets.emplace_back(*res.packet());
+  }
+  REQUIRE(packets.size() == 1);
+  REQUIRE(packets[0].starts_with("/EST5\\253710000_A\r\n"));
+}
+
+TEST_CASE("In-place decryption receives many packets") {
+  std::array<char, 500> buffer;
+
+  auto accumulator = EncryptedPacketAccumulator(buffer);
+  REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA").has_value());
+
+  const auto& garbage = std::vector<std::uint8_t>(100, 0x55);
+
+  auto packet_corrupted = encrypted_packet;
+  packet_corrupted[50] ^= 0xFF;
+
+  auto packet_too_short_length = encrypted_packet;
+  change_length(packet_too_short_length, 16);
+
+  auto packet_too_long_length = encrypted_packet;
+  change_length(packet_too_long_length, 2000);
+
+  std::vector<std::string> received_packets;
+  std::vector<EncryptedPacketAccumulator::Error> occurred_errors;
+
+  for (const auto byte : concat(garbage, encrypted_packet, garbage, packet_too_short_length, packet_corrupted, encrypted_packet, packet_corrupted,
+                                encrypted_packet, packet_too_long_length, encrypted_packet)) {
+    auto res = accumulator.process_byte(byte);
+
+    if (res.packet()) {
+      received_packets.emplace_back(*res.packet());
+    }
+
+    if (res.error()) {
+      occurred_errors.push_back(*res.error());
+    }
+  }
+
+  REQUIRE(received_packets.size() == 4);
+  for (const auto& packet : received_packets)
+    REQUIRE(packet.ends_with("1-0:4.7.0(000000166*var)\r\n!7EF9\r\n"));
+
+  using enum EncryptedPacketAccumulator::Error;
+  REQUIRE(occurred_errors == std::vector{HeaderCorrupted, HeaderCorrupted, HeaderCorrupted, HeaderCorrupted, DecryptionFailed, DecryptionFailed, BufferOverflow,
+                                         HeaderCorrupted, HeaderCorrupted, HeaderCorrupted});
+}
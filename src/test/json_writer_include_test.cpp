@@ -0,0 +1,13 @@
+// This code tests that the JSON writer has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/json_writer.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void JsonWriter_some_function() {
+  ParsedData<identification, p1_version> data;
+  char buffer[64];
+  JsonWriter::write(data, buffer);
+}
@@ -0,0 +1,81 @@
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/json_writer.h"
+#include <array>
+#include <doctest.h>
+#include <string>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+namespace {
+using Data = ParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, energy_returned_tariff1, power_delivered, electricity_threshold,
+                        electricity_switch_position, electricity_failures, gas_delivered, message_long>;
+
+const auto& msg = "/KFM5KAIFA-METER\r\n"
+                  "\r\n"
+                  "1-3:0.2.8(40)\r\n"
+                  "0-0:1.0.0(150117185916W)\r\n"
+                  "1-0:1.8.1(000671.578*kWh)\r\n"
+                  "1-0:2.8.1(000000.000*kWh)\r\n"
+                  "1-0:1.7.0(00.033*kW)\r\n"
+                  "0-0:17.0.0(999.9*kW)\r\n"
+                  "0-0:96.3.10(1)\r\n"
+                  "0-0:96.7.21(00008)\r\n"
+                  "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                  "!";
+
+Data parse() {
+  Data data;
+  REQUIRE(P1Parser::parse(&data, msg, std::size(msg) - 1, /*unknown_error=*/true, /*check_crc=*/false).err == nullptr);
+  return data;
+}
+
+template <typename... Ts>
+std::string to_json(const ParsedData<Ts...>& data, const bool with_units = false) {
+  std::array<char, 1024> buffer;
+  const auto size = JsonWriter::write(data, buffer, with_units);
+  REQUIRE(size > 0);
+  return std::string(buffer.data(), size);
+}
+}
+
+TEST_CASE("JsonWriter writes the present fields") {
+  REQUIRE(to_json(parse()) == "{\"identification\":\"KFM5KAIFA-METER\",\"p1_version\":\"40\",\"timestamp\":\"150117185916W\","
+                              "\"energy_delivered_tariff1\":671.578,\"energy_returned_tariff1\":0.000,\"power_delivered\":0.033,"
+                              "\"electricity_threshold\":999.900,\"electricity_switch_position\":1,\"electricity_failures\":8,"
+                              "\"gas_delivered\":{\"value\":473.789,\"timestamp\":\"150117180000W\"}}");
+}
+
+TEST_CASE("JsonWriter writes the units") {
+  REQUIRE(to_json(parse(), true) == "{\"identification\":\"KFM5KAIFA-METER\",\"p1_version\":\"40\",\"timestamp\":\"150117185916W\","
+                                    "\"energy_delivered_tariff1\":{\"value\":671.578,\"unit\":\"kWh\"},"
+                                    "\"energy_returned_tariff1\":{\"value\":0.000,\"unit\":\"kWh\"},"
+                                    "\"power_delivered\":{\"value\":0.033,\"unit\":\"kW\"},\"electricity_threshold\":{\"value\":999.900,\"unit\":\"kW\"},"
+                                    "\"electricity_switch_position\":1,\"electricity_failures\":8,"
+                                    "\"gas_delivered\":{\"value\":473.789,\"unit\":\"m3\",\"timestamp\":\"150117180000W\"}}");
+}
+
+TEST_CASE("JsonWriter writes an empty object if no field is present") {
+  REQUIRE(to_json(Data()) == "{}");
+  REQUIRE(to_json(Data(), true) == "{}");
+}
+
+TEST_CASE("JsonWriter escapes strings") {
+  ParsedData<identification, message_long> data;
+  assign_string(data.identification, std::string_view("a\"b\\c\r\nd\x01", 9));
+  data.identification_present = true;
+  assign_string(data.message_long, "caf\xc3\xa9");
+  data.message_long_present = true;
+  REQUIRE(to_json(data) == "{\"identification\":\"a\\\"b\\\\c\\u000d\\u000ad\\u0001\",\"message_long\":\"caf\xc3\xa9\"}");
+}
+
+TEST_CASE("JsonWriter returns 0 if the JSON doesn't fit") {
+  const auto data = parse();
+  std::array<char, 1024> buffer;
+  const auto size = JsonWriter::write(data, buffer);
+  REQUIRE(size > 0);
+
+  for (size_t smaller_size = 0; smaller_size < size; ++smaller_size)
+    REQUIRE(JsonWriter::write(data, std::span(buffer).first(smaller_size)) == 0);
+  REQUIRE(JsonWriter::write(data, std::span(buffer).first(size)) == size);
+}
@@ -0,0 +1,9 @@
+// This code tests that the line_splitter header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/line_splitter.h"
+
+bool LineSplitter_some_function() {
+  const char data[] = "1-0:1.8.1(1)\r\n";
+  return !arduino_dsmr_2::split_logical_lines(data, data + sizeof(data) - 1, [](const char*, const char*) { return arduino_dsmr_2::ParseResult<void>(); }).err;
+}
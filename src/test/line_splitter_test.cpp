@@ -0,0 +1,153 @@
+#include "arduino-dsmr-2/line_splitter.h"
+#include <cstdint>
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+struct SplitResult {
+  std::vector<std::string> lines;
+  const char* error = nullptr;
+  const char* error_position = nullptr;
+
+  bool operator==(const SplitResult&) const = default;
+};
+
+// The way P1Parser::parse_data used to split lines: look at every character one at a time
+SplitResult split_byte_by_byte(const std::string& data) {
+  SplitResult res;
+  const char* const end = data.data() + data.size();
+  const char* line_start = data.data();
+  const char* line_end = data.data();
+  bool open_bracket_found = false;
+  while (line_end < end) {
+    const char c = *line_end;
+    if (c == '(') {
+      if (open_bracket_found) {
+        res.error = "Unexpected '(' symbol";
+        res.error_position = line_end;
+        return res;
+      }
+      open_bracket_found = true;
+    } else if (c == ')') {
+      if (!open_bracket_found) {
+        res.error = "Unexpected ')' symbol";
+        res.error_position = line_end;
+        return res;
+      }
+      open_bracket_found = false;
+    } else if (c == '\r' || c == '\n') {
+      const bool next_part_of_the_data_line_on_next_line = (end - line_end > 2) && (line_end[1] == '(' || line_end[2] == '(');
+      if (!open_bracket_found && !next_part_of_the_data_line_on_next_line) {
+        res.lines.emplace_back(line_start, line_end);
+        line_start = line_end + 1;
+      }
+    }
+    ++line_end;
+  }
+
+  if (line_end != line_start) {
+    res.error = "Last dataline not CRLF terminated";
+    res.error_position = line_end;
+  }
+  return res;
+}
+
+template <typename Scanner>
+SplitResult split(const std::string& data) {
+  SplitResult res;
+  const auto& parse_res = split_logical_lines<Scanner>(data.data(), data.data() + data.size(), [&](const char* line, const char* end) {
+    res.lines.emplace_back(line, end);
+    return ParseResult<void>();
+  });
+  if (parse_res.err) {
+    res.error = parse_res.err;
+    res.error_position = parse_res.ctx;
+  }
+  return res;
+}
+
+template <typename Scanner>
+void check_scanner_matches_byte_by_byte_splitting(const std::string& data) {
+  REQUIRE(split<Scanner>(data) == split_byte_by_byte(data));
+}
+
+void check_all_scanners(const std::string& data) {
+  check_scanner_matches_byte_by_byte_splitting<ScalarStructuralScanner>(data);
+#ifdef DSMR_HAS_SSE2
+  check_scanner_matches_byte_by_byte_splitting<Sse2StructuralScanner>(data);
+#endif
+#ifdef DSMR_HAS_AVX2
+  check_scanner_matches_byte_by_byte_splitting<Avx2StructuralScanner>(data);
+#endif
+#ifdef DSMR_HAS_NEON
+  check_scanner_matches_byte_by_byte_splitting<NeonStructuralScanner>(data);
+#endif
+  check_scanner_matches_byte_by_byte_splitting<StructuralScanner>(data);
+}
+}
+
+TEST_CASE("Logical lines are split on line breaks outside of brackets") {
+  const std::string data = "1-0:1.8.1(000671.578*kWh)\r\n"
+                           "0-0:96.13.0(303132333435\r\n"
+                           "30313233343)\r\n"
+                           "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                           "(00124.477)\r\n";
+  const auto& res = split<StructuralScanner>(data);
+  REQUIRE(res.error == nullptr);
+  // The '\n' after '\r' ends an empty line, which parse_line skips
+  REQUIRE(res.lines == std::vector<std::string>{"1-0:1.8.1(000671.578*kWh)", "", "0-0:96.13.0(303132333435\r\n30313233343)", "",
+                                                "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n(00124.477)", ""});
+}
+
+TEST_CASE("Bracket errors are reported at the position of the bracket") {
+  const std::string data = "1-0:1.8.1(000671.578*kWh)\r\n"
+                           "1-0:1.8.2(00(0842.472*kWh)\r\n";
+  const auto& res = split<StructuralScanner>(data);
+  REQUIRE(res.lines.size() == 2);
+  REQUIRE(std::string(res.error) == "Unexpected '(' symbol");
+  REQUIRE(res.error_position == data.data() + data.find("(0842"));
+}
+
+TEST_CASE("Splitting stops at the first error of the line callback") {
+  const std::string data = "a\nb\nc\n";
+  std::size_t calls = 0;
+  const auto& res = split_logical_lines(data.data(), data.data() + data.size(), [&](const char* line, const char*) {
+    ++calls;
+    return *line == 'b' ? ParseResult<void>().fail("Bad line", line) : ParseResult<void>();
+  });
+  REQUIRE(calls == 2);
+  REQUIRE(std::string(res.err) == "Bad line");
+}
+
+TEST_CASE("All structural scanners split lines like the byte by byte loop") {
+  SUBCASE("Real telegram at every possible length") {
+    const std::string telegram = "1-3:0.2.8(50)\r\n"
+                                 "0-0:1.0.0(170124213128W)\r\n"
+                                 "0-0:96.13.0(303132333435363738393A3B3C3D3E3F303132333435363738393A3B3C3D3E3F\r\n"
+                                 "303132333435363738393A3B3C3D3E3F)\r\n"
+                                 "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                                 "(00124.477)\r\n"
+                                 "1-0:99.97.0(2)(0-0:96.7.19)(000101000006W)(2147483647*s)(000102000003W)(2317482647*s)\r\n";
+    for (std::size_t len = 0; len <= telegram.size(); ++len)
+      check_all_scanners(telegram.substr(0, len));
+  }
+
+  SUBCASE("Random combinations of structural symbols") {
+    // Structural symbols in every position of a block, next to each other and at the block boundaries.
+    // The bytes with the highest bit set differ from the structural symbols only in that bit.
+    const char alphabet[] = {'(', ')', '\r', '\n', '1', 'a', '(', ')', '\r', '\n', '*', '\xFF', '\xA8', '\xA9', '\x8A', '\x8D'};
+    uint32_t state = 12345;
+    for (std::size_t i = 0; i < 2000; ++i) {
+      std::string data;
+      const std::size_t len = i % 97;
+      for (std::size_t j = 0; j < len; ++j) {
+        state = state * 1103515245 + 12345;
+        data += alphabet[(state >> 16) % sizeof(alphabet)];
+      }
+      check_all_scanners(data);
+    }
+  }
+}
@@ -0,0 +1,12 @@
+// This code tests that the memory instrumentation has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/memory_instrumentation.h"
+
+using namespace arduino_dsmr_2;
+
+void memory_instrumentation_some_function() {
+  memory_instrumentation::record_allocation(1);
+  [[maybe_unused]] const auto& stats = memory_instrumentation::parser_stats();
+  [[maybe_unused]] const memory_instrumentation::ParseScope scope;
+}
@@ -0,0 +1,158 @@
+#define DSMR_MEMORY_INSTRUMENTATION_IMPLEMENT_ALLOCATION_HOOKS
+#include "arduino-dsmr-2/encrypted_packet_accumulator.h"
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/memory_instrumentation.h"
+#include "arduino-dsmr-2/packet_accumulator.h"
+#include "arduino-dsmr-2/parser.h"
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+static_assert(DSMR_MEMORY_INSTRUMENTATION, "The tests are compiled with DSMR_MEMORY_INSTRUMENTATION=1");
+
+TEST_CASE("Replaced operator new counts the allocations of the current thread") {
+  const auto before = memory_instrumentation::thread_allocations();
+  const auto value = std::make_unique<uint64_t>(1);
+  const auto after = memory_instrumentation::thread_allocations();
+
+  REQUIRE(after.allocations - before.allocations == 1);
+  REQUIRE(after.bytes - before.bytes == sizeof(uint64_t));
+}
+
+TEST_CASE("Records the allocations of every P1Parser::parse call") {
+  const std::string long_identification = "/KFM5KAIFA-METER with a name that doesn't fit into the small string buffer";
+  const auto msg = long_identification + "\r\n"
+                                         "\r\n"
+                                         "1-0:1.8.1(000671.578*kWh)\r\n"
+                                         "!";
+  auto& stats = memory_instrumentation::parser_stats();
+  const auto previous = stats;
+
+  ParsedData<identification, energy_delivered_tariff1> data_with_string;
+  REQUIRE(!P1Parser::parse(&data_with_string, msg.data(), msg.size(), false, false).err);
+
+  REQUIRE(stats.parse_calls == previous.parse_calls + 1);
+  if constexpr (std::is_same_v<configured_string<1>, std::string>) {
+    REQUIRE(stats.last.allocations >= 1);
+    REQUIRE(stats.last.bytes >= long_identification.size() - 1);
+  } else {
+    // FixedString and std::string_view fields don't allocate
+    REQUIRE(stats.last.allocations == 0);
+  }
+  REQUIRE(stats.max.allocations >= stats.last.allocations);
+  REQUIRE(stats.max.bytes >= stats.last.bytes);
+  REQUIRE(stats.total.allocations == previous.total.allocations + stats.last.allocations);
+  REQUIRE(stats.total.bytes == previous.total.bytes + stats.last.bytes);
+
+  const auto after_first_parse = stats;
+  ParsedData<energy_delivered_tariff1> data_without_strings;
+  REQUIRE(!P1Parser::parse(&data_without_strings, msg.data(), msg.size(), false, false).err);
+
+  REQUIRE(stats.parse_calls == previous.parse_calls + 2);
+  REQUIRE(stats.last.allocations == 0);
+  REQUIRE(stats.last.bytes == 0);
+  REQUIRE(stats.max.allocations == after_first_parse.max.allocations);
+  REQUIRE(stats.total.allocations == after_first_parse.total.allocations);
+}
+
+TEST_CASE("Failed P1Parser::parse calls are recorded too") {
+  const auto& msg = "/AAA5MTR\r\n!0000";
+  auto& stats = memory_instrumentation::parser_stats();
+  const auto previous_calls = stats.parse_calls;
+
+  ParsedData<identification> data;
+  REQUIRE(P1Parser::parse(&data, msg, std::size(msg) - 1).err);
+  REQUIRE(stats.parse_calls == previous_calls + 1);
+}
+
+TEST_CASE("ParsedData reports the size of every field") {
+  using Data = ParsedData<identification, energy_delivered_tariff1, electricity_failures>;
+  constexpr auto footprints = Data::field_footprints();
+
+  static_assert(footprints.size() == 3);
+  static_assert(std::string_view(footprints[0].name) == "identification");
+  static_assert(footprints[0].size == sizeof(identification));
+  static_assert(std::string_view(footprints[1].name) == "energy_delivered_tariff1");
+  static_assert(footprints[1].size == sizeof(energy_delivered_tariff1));
+  static_assert(std::string_view(footprints[2].name) == "electricity_failures");
+  static_assert(footprints[2].size == sizeof(electricity_failures));
+
+  size_t sum = 0;
+  for (const auto& footprint : footprints)
+    sum += footprint.size;
+  REQUIRE(sum <= sizeof(Data));
+}
+
+TEST_CASE("PacketAccumulator tracks the high-water mark of its buffer") {
+  std::vector<char> buffer(20);
+  PacketAccumulator accumulator(buffer, false);
+  REQUIRE(accumulator.buffer_high_water_mark() == 0);
+
+  for (const auto& byte : std::string_view("/long packet!/short!"))
+    accumulator.process_byte(byte);
+  REQUIRE(accumulator.buffer_high_water_mark() == std::string_view("/long packet!").size());
+
+  SUBCASE("process") {
+    accumulator.process(std::string_view("/a much longer packet!"), [](const auto&) {});
+    REQUIRE(accumulator.buffer_high_water_mark() == buffer.size());
+  }
+
+  SUBCASE("process_byte") {
+    bool overflow = false;
+    for (const auto& byte : std::string_view("/a much longer packet!"))
+      overflow |= accumulator.process_byte(byte).error() == PacketAccumulator::Error::BufferOverflow;
+    REQUIRE(overflow);
+    REQUIRE(accumulator.buffer_high_water_mark() == buffer.size());
+  }
+}
+
+static std::vector<uint8_t> read_encrypted_packet() {
+  std::ifstream file(std::filesystem::path(std::source_location::current().file_name()).parent_path() / "test_data" / "encrypted_packet.bin", std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+TEST_CASE("EncryptedPacketAccumulator tracks the buffer size that packets need") {
+  const auto& packet = read_encrypted_packet();
+  const auto header_size = 18;
+  const auto gcm_tag_size = 12;
+
+  SUBCASE("Separate buffers") {
+    std::vector<uint8_t> encrypted_packet_buffer(2000);
+    std::vector<char> decrypted_packet_buffer(2000);
+    EncryptedPacketAccumulator accumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+    REQUIRE(accumulator.buffer_high_water_mark() == 0);
+
+    for (const auto& byte : packet)
+      accumulator.process_byte(byte);
+    REQUIRE(accumulator.buffer_high_water_mark() == packet.size() - header_size);
+  }
+
+  SUBCASE("Single buffer") {
+    std::vector<char> buffer(2000);
+    EncryptedPacketAccumulator accumulator(buffer);
+
+    for (const auto& byte : packet)
+      accumulator.process_byte(byte);
+    REQUIRE(accumulator.buffer_high_water_mark() == packet.size() - header_size - gcm_tag_size);
+  }
+
+  SUBCASE("Packets that don't fit are counted") {
+    std::vector<uint8_t> encrypted_packet_buffer(100);
+    std::vector<char> decrypted_packet_buffer(100);
+    EncryptedPacketAccumulator accumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+
+    bool overflow = false;
+    for (const auto& byte : packet)
+      overflow |= accumulator.process_byte(byte).error() == EncryptedPacketAccumulator::Error::BufferOverflow;
+    REQUIRE(overflow);
+    REQUIRE(accumulator.buffer_high_water_mark() == packet.size() - header_size);
+  }
+}
@@ -0,0 +1,136 @@
+#include "arduino-dsmr-2/parser.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+namespace {
+// The digit by digit implementation of NumParser::parse that the SWAR version replaced
+ParseResult<uint32_t> parse_digit_by_digit(size_t max_decimals, const char* unit, const char* str, const char* end) {
+  ParseResult<uint32_t> res;
+  if (str >= end || *str != '(')
+    return res.fail("Missing (", str);
+
+  const char* num_start = str + 1;
+  const char* num_end = num_start;
+  uint32_t value = 0;
+
+  while (num_end < end && !strchr("*.)", *num_end)) {
+    if (*num_end < '0' || *num_end > '9')
+      return res.fail(INVALID_NUMBER, num_end);
+    value *= 10;
+    value += static_cast<uint32_t>(*num_end - '0');
+    ++num_end;
+  }
+
+  if (max_decimals && num_end < end && *num_end == '.') {
+    ++num_end;
+    while (num_end < end && !strchr("*)", *num_end) && max_decimals) {
+      max_decimals--;
+      if (*num_end < '0' || *num_end > '9')
+        return res.fail(INVALID_NUMBER, num_end);
+      value *= 10;
+      value += static_cast<uint32_t>(*num_end - '0');
+      ++num_end;
+    }
+  }
+
+  while (max_decimals--)
+    value *= 10;
+
+  if (unit && *unit && (num_end >= end || (*num_end != '*' && *num_end != '.')) && value == 0) {
+    num_end = std::find(num_end, end, ')');
+  } else if (unit && *unit) {
+    if (num_end >= end || *num_end != '*')
+      return res.fail("Missing unit", num_end);
+    const char* unit_start = ++num_end;
+    while (num_end < end && *num_end != ')' && *unit) {
+      if (std::tolower(static_cast<unsigned char>(*num_end++)) != std::tolower(static_cast<unsigned char>(*unit++)))
+        return res.fail(INVALID_UNIT, unit_start);
+    }
+    if (*unit)
+      return res.fail(INVALID_UNIT, unit_start);
+  }
+
+  if (num_end >= end || *num_end != ')')
+    return res.fail("Extra data", num_end);
+
+  return res.succeed(value).until(num_end + 1);
+}
+
+// The messages are compared by content: the same string literal can have different addresses in different translation units
+std::string error_message(const char* err) { return err ? err : "no error"; }
+
+void check_same_result(const std::string& value, const size_t max_decimals, const char* unit) {
+  // Copy the value into an exactly sized buffer, so that the address sanitizer catches reads past the end
+  const std::vector<char> buffer(value.begin(), value.end());
+  const char* const begin = buffer.data();
+  const char* const end = begin + buffer.size();
+
+  const auto& expected = parse_digit_by_digit(max_decimals, unit, begin, end);
+  const auto& actual = NumParser::parse(max_decimals, unit, begin, end);
+  REQUIRE(error_message(actual.err) == error_message(expected.err));
+  REQUIRE(actual.ctx == expected.ctx);
+  REQUIRE(actual.next == expected.next);
+  if (!expected.err)
+    REQUIRE(actual.result == expected.result);
+}
+
+void check_all_units(const std::string& value) {
+  for (const char* unit : {"", "kWh", "Wh", "m3", "kvarh", "V", "s", "longunit"}) {
+    for (size_t max_decimals = 0; max_decimals <= 3; ++max_decimals) {
+      check_same_result(value, max_decimals, unit);
+    }
+  }
+}
+}
+
+TEST_CASE("NumParser parses typical values") {
+  const std::string value = "(000671.578*kWh)";
+  const auto& res = NumParser::parse(3, "kWh", value.data(), value.data() + value.size());
+  REQUIRE(res.err == nullptr);
+  REQUIRE(res.result == 671578);
+  REQUIRE(res.next == value.data() + value.size());
+
+  const std::string long_value = "(0000000240*s)";
+  REQUIRE(NumParser::parse(0, "s", long_value.data(), long_value.data() + long_value.size()).result == 240);
+
+  const std::string upper_case_unit = "(01.193*KW)";
+  REQUIRE(NumParser::parse(3, "kW", upper_case_unit.data(), upper_case_unit.data() + upper_case_unit.size()).result == 1193);
+}
+
+TEST_CASE("NumParser gives the same results as the digit by digit implementation") {
+  SUBCASE("Values from real telegrams and their prefixes") {
+    for (const std::string value : {"(000671.578*kWh)", "(00.333*kW)", "(0000000240*s)", "(006545766*Wh)", "(003897726*varh)", "(12785.123*m3)", "(220.1*V)",
+                                    "(001*A)", "(0999.00*kW)", "(000.00*A)", "(0)", "(00000)", "(4294967295)", "(99999999999999999999*kWh)", "(1.2345678*kWh)",
+                                    "(12345678.901*kWh)", "(1*kwh)", "(1*KWH)", "(1*kWhh)", "(1*kW)", "(1*k)", "(1.*kWh)", "(.5*kWh)", "(1.2.3*kWh)",
+                                    "(1a*kWh)", "(1.2a*kWh)", "(0*)", "(0.000)", "(1*kWh)x", "(1*kWh", "(1*kWh)(2)", "(12345678*kWh)", "(123456789)"}) {
+      for (size_t len = 0; len <= value.size(); ++len)
+        check_all_units(value.substr(0, len));
+    }
+  }
+
+  SUBCASE("Digit runs of every length") {
+    const std::string digits = "98765432109876543210";
+    for (size_t len = 1; len <= digits.size(); ++len) {
+      check_all_units("(" + digits.substr(0, len) + ")");
+      check_all_units("(" + digits.substr(0, len) + ".75*kWh)");
+      check_all_units("(1." + digits.substr(0, len) + "*kWh)");
+    }
+  }
+
+  SUBCASE("Random values") {
+    const char alphabet[] = {'0', '1', '5', '9', '.', '*', ')', 'k', 'W', 'h', 'w', 'H', '/', ':', '\0', '\xFA', '\xFF', '0', '3', '8'};
+    uint32_t state = 42;
+    for (size_t i = 0; i < 3000; ++i) {
+      std::string value = "(";
+      const size_t len = i % 24;
+      for (size_t j = 0; j < len; ++j) {
+        state = state * 1103515245 + 12345;
+        value += alphabet[(state >> 16) % sizeof(alphabet)];
+      }
+      check_all_units(value);
+    }
+  }
+}
@@ -1,8 +1,10 @@
 #include "arduino-dsmr-2/fields.h"
 #include "arduino-dsmr-2/packet_accumulator.h"
 #include "arduino-dsmr-2/parser.h"
+#include <array>
+#include <cstdio>
 #include <doctest.h>
-#include <iostream>
+#include <string_view>
 
 using namespace arduino_dsmr_2;
 using namespace fields;
@@ -71,10 +73,18 @@ TEST_CASE("PacketAccumulator example") {
       P1Parser::parse(&data, packet.data(), packet.size(), /* unknown_error */ false, /* check_crc */ false);
 
       // Now you can use the parsed data.
-      printf("Identification: %s\n", data.identification.c_str());
-      printf("P1 version: %s\n", data.p1_version.c_str());
-      printf("Timestamp: %s\n", data.timestamp.c_str());
-      printf("Equipment ID: %s\n", data.equipment_id.c_str());
+      // The string fields are printed through std::string_view, so this works for std::string, FixedString and std::string_view fields alike.
+      const auto print = [](const char* name, const std::string_view value) { printf("%s: %.*s\n", name, static_cast<int>(value.size()), value.data()); };
+      print("Identification", data.identification);
+      print("P1 version", data.p1_version);
+#if DSMR_TYPED_TIMESTAMPS
+      // A Timestamp is printed as its YYMMDDhhmmssX text
+      const auto timestamp = data.timestamp.text();
+      print("Timestamp", std::string_view(timestamp.data(), timestamp.size()));
+#else
+      print("Timestamp", data.timestamp);
+#endif
+      print("Equipment ID", data.equipment_id);
       printf("Energy delivered tariff 1: %.3f\n", static_cast<double>(data.energy_delivered_tariff1.val()));
     }
   }
@@ -128,3 +128,109 @@ TEST_CASE("Parse data with different packets. No CRC check") {
   REQUIRE(occurred_errors == std::vector{PacketStartSymbolInPacket, BufferOverflow});
   REQUIRE(received_packets == std::vector<std::string>(4, "/some !"));
 }
+
+struct ReceivedData {
+  std::vector<std::string> packets;
+  std::vector<PacketAccumulator::Error> errors;
+  bool operator==(const ReceivedData&) const = default;
+};
+
+static ReceivedData process_byte_by_byte(std::string_view msg, std::size_t buffer_size, bool check_crc) {
+  std::vector<char> buffer(buffer_size);
+  PacketAccumulator accumulator(buffer, check_crc);
+  ReceivedData received;
+  for (const auto& byte : msg) {
+    const auto& res = accumulator.process_byte(byte);
+    if (res.error()) {
+      received.errors.push_back(*res.error());
+    }
+    if (res.packet()) {
+      received.packets.push_back(std::string(*res.packet()));
+    }
+  }
+  return received;
+}
+
+static ReceivedData process_in_chunks(std::string_view msg, std::size_t buffer_size, bool check_crc, std::size_t chunk_size) {
+  std::vector<char> buffer(buffer_size);
+  PacketAccumulator accumulator(buffer, check_crc);
+  ReceivedData received;
+  for (std::size_t i = 0; i < msg.size(); i += chunk_size) {
+    accumulator.process(msg.substr(i, chunk_size), [&](const PacketAccumulator::Result& res) {
+      if (res.error()) {
+        received.errors.push_back(*res.error());
+      }
+      if (res.packet()) {
+        received.packets.push_back(std::string(*res.packet()));
+      }
+    });
+  }
+  return received;
+}
+
+TEST_CASE("Processing data in chunks gives the same result as processing it byte by byte") {
+  const std::string_view msg = "garbage /some !a3D4"      // correct package
+                               "garbage /some !a3D3"      // CRC mismatch
+                               "garbage /so/some !a3D4"   // Packet start symbol '/' in the middle of the packet
+                               "garbage /some !a3G4"      // Incorrect CRC character
+                               "/some !a3D4"              // correct package
+                               "/garbage garbage garbage" // buffer overflow
+                               "/some !a3D4"              // correct package
+                               "/123456789012345"         // packet that fills the whole buffer
+                               "garbage /some !a3D4";     // buffer overflow, followed by a correct package
+
+  for (const auto check_crc : {true, false}) {
+    const auto& expected = process_byte_by_byte(msg, 15, check_crc);
+    REQUIRE(expected.packets.size() == (check_crc ? 5u : 7u));
+
+    for (std::size_t chunk_size = 1; chunk_size <= msg.size(); ++chunk_size) {
+      REQUIRE(process_in_chunks(msg, 15, check_crc, chunk_size) == expected);
+    }
+  }
+}
+
+TEST_CASE("Rotating buffers keep the packets until they are released") {
+  std::vector<char> buffer1(15), buffer2(15), buffer3(15);
+  const std::span<char> buffers[] = {buffer1, buffer2, buffer3};
+  auto accumulator = PacketAccumulator::rotating(buffers, true);
+
+  std::vector<std::string_view> packets;
+  std::vector<PacketAccumulator::Error> errors;
+  const auto feed = [&](std::string_view bytes, std::size_t chunk_size) {
+    for (std::size_t i = 0; i < bytes.size(); i += chunk_size) {
+      accumulator.process(bytes.substr(i, chunk_size), [&](const auto& res) {
+        if (res.error())
+          errors.push_back(*res.error());
+        if (res.packet())
+          packets.push_back(*res.packet());
+      });
+    }
+  };
+
+  // The packets in the same chunk don't overwrite each other. The failed packets don't take a buffer.
+  feed("/one !B906/two !0000/three !B791", 100);
+  REQUIRE(errors == std::vector{PacketAccumulator::Error::CrcMismatch});
+  REQUIRE(packets == std::vector<std::string_view>{"/one !", "/three !"});
+  REQUIRE(packets[0].data() == buffer1.data());
+  REQUIRE(packets[1].data() == buffer2.data());
+
+  // The caller holds two buffers, so the third packet is received and then dropped
+  feed("/four !C260", 3);
+  REQUIRE(errors.back() == PacketAccumulator::Error::NoFreeBuffer);
+  REQUIRE(packets.size() == 2);
+  REQUIRE(packets[0] == "/one !");
+  REQUIRE(packets[1] == "/three !");
+
+  accumulator.release_packet(packets[0]);
+  feed("/four !C260/five !8258", 1);
+  REQUIRE(packets.size() == 3);
+  REQUIRE(packets[2] == "/four !");
+  REQUIRE(packets[2].data() == buffer3.data());
+  REQUIRE(errors.back() == PacketAccumulator::Error::NoFreeBuffer);
+
+  accumulator.release_packet(packets[1]);
+  accumulator.release_packet(packets[2]);
+  feed("/five !8258", 4);
+  REQUIRE(packets.size() == 4);
+  REQUIRE(packets[3] == "/five !");
+}
@@ -0,0 +1,6 @@
+// This code tests that the packet_pipeline header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/packet_pipeline.h"
+
+void PacketPipeline_some_function() { arduino_dsmr_2::PacketPipeline<16, 2, 16> pipeline(true); }
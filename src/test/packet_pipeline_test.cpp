@@ -0,0 +1,148 @@
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/packet_pipeline.h"
+#include "arduino-dsmr-2/parser.h"
+#include "test_helpers.h"
+#include <atomic>
+#include <doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::telegram;
+
+namespace {
+uint32_t energy(const std::string_view packet) {
+  ParsedData<energy_delivered_tariff1> data;
+  REQUIRE(!P1Parser::parse(&data, packet.data(), packet.size(), false, false).err);
+  return data.energy_delivered_tariff1.int_val();
+}
+}
+
+TEST_CASE("PacketPipeline hands the packets over without copying") {
+  PacketPipeline<256, 3, 100> pipeline(true);
+  REQUIRE(pipeline.push(telegram(1) + "garbage" + telegram(2)));
+  REQUIRE(!pipeline.acquire_packet());
+  pipeline.process();
+
+  const auto first = pipeline.acquire_packet();
+  const auto second = pipeline.acquire_packet();
+  REQUIRE(first);
+  REQUIRE(second);
+  REQUIRE(!pipeline.acquire_packet());
+  REQUIRE(first->buffer_index != second->buffer_index);
+  REQUIRE(first->data == telegram(1).substr(0, telegram(1).find('!') + 1));
+  REQUIRE(energy(second->data) == 2);
+
+  // A released buffer is reused for a later packet
+  pipeline.release_packet(*first);
+  REQUIRE(pipeline.push(telegram(3)));
+  pipeline.process();
+  const auto third = pipeline.acquire_packet();
+  REQUIRE(third);
+  REQUIRE(energy(third->data) == 3);
+  REQUIRE(energy(second->data) == 2);
+  REQUIRE(pipeline.dropped_packets() == 0);
+}
+
+TEST_CASE("PacketPipeline reports errors and drops what doesn't fit") {
+  PacketPipeline<32, 2, 100> pipeline(true);
+  auto corrupted = telegram(1);
+  corrupted[3] = 'X';
+
+  std::vector<PacketAccumulator::Error> errors;
+  const auto feed = [&](const std::string& bytes) {
+    for (size_t offset = 0; offset < bytes.size(); offset += 30) {
+      REQUIRE(pipeline.push(bytes.substr(offset, 30)));
+      pipeline.process([&](PacketAccumulator::Error error) { errors.push_back(error); });
+    }
+  };
+
+  // The byte ring is smaller than a packet
+  REQUIRE(!pipeline.push(telegram(1)));
+  REQUIRE(pipeline.dropped_bytes() == telegram(1).size() - 32);
+  pipeline.process();
+  REQUIRE(!pipeline.acquire_packet());
+
+  // The truncated packet is interrupted by the next one
+  feed(corrupted + telegram(2));
+  REQUIRE(errors == std::vector{PacketAccumulator::Error::PacketStartSymbolInPacket, PacketAccumulator::Error::CrcMismatch});
+
+  // The consumer holds the only other buffer, so the next packet is dropped
+  const auto packet = pipeline.acquire_packet();
+  REQUIRE(packet);
+  REQUIRE(energy(packet->data) == 2);
+  feed(telegram(3));
+  REQUIRE(errors.back() == PacketAccumulator::Error::NoFreeBuffer);
+  REQUIRE(pipeline.dropped_packets() == 1);
+  REQUIRE(!pipeline.acquire_packet());
+
+  pipeline.release_packet(*packet);
+  feed(telegram(4));
+  REQUIRE(energy(pipeline.acquire_packet()->data) == 4);
+}
+
+TEST_CASE("PacketPipeline passes packets from an interrupt through a parser task to a consumer") {
+  constexpr uint32_t number_of_packets = 2000;
+  PacketPipeline<128, 4, 100> pipeline(true);
+  std::atomic<bool> interrupt_done = false;
+  std::atomic<bool> parser_done = false;
+
+  // Every 10th packet is corrupted
+  std::string stream;
+  for (uint32_t i = 0; i < number_of_packets; ++i) {
+    auto packet = telegram(i);
+    if (i % 10 == 9)
+      packet[3] = 'X';
+    stream += packet;
+  }
+
+  // The interrupt pushes one byte at a time and retries when the ring is full
+  uint32_t retries = 0;
+  std::thread interrupt([&] {
+    for (const char& byte : stream) {
+      while (!pipeline.push(std::span(&byte, 1))) {
+        ++retries;
+        std::this_thread::yield();
+      }
+    }
+    interrupt_done = true;
+  });
+
+  uint32_t errors = 0;
+  std::thread parser_task([&] {
+    for (bool finished = false; !finished;) {
+      finished = interrupt_done;
+      pipeline.process([&](PacketAccumulator::Error error) {
+        if (error != PacketAccumulator::Error::NoFreeBuffer) {
+          REQUIRE(error == PacketAccumulator::Error::CrcMismatch);
+          ++errors;
+        }
+      });
+      std::this_thread::yield();
+    }
+    parser_done = true;
+  });
+
+  std::vector<uint32_t> received;
+  for (bool finished = false; !finished;) {
+    finished = parser_done;
+    while (const auto packet = pipeline.acquire_packet()) {
+      received.push_back(energy(packet->data));
+      pipeline.release_packet(*packet);
+    }
+    std::this_thread::yield();
+  }
+  interrupt.join();
+  parser_task.join();
+
+  REQUIRE(pipeline.dropped_bytes() == retries);
+  REQUIRE(errors == number_of_packets / 10);
+  REQUIRE(received.size() + pipeline.dropped_packets() + errors == number_of_packets);
+  for (size_t i = 0; i < received.size(); ++i) {
+    REQUIRE(received[i] % 10 != 9);
+    if (i > 0)
+      REQUIRE(received[i] > received[i - 1]);
+  }
+}
@@ -1,10 +1,13 @@
 #include "arduino-dsmr-2/fields.h"
 #include "arduino-dsmr-2/parser.h"
+#include "test_helpers.h"
 #include <doctest.h>
 #include <iostream>
+#include <sstream>
 
 using namespace arduino_dsmr_2;
 using namespace fields;
+using test_helpers::timestamp_text;
 
 struct Printer {
   template <typename Item>
@@ -108,7 +111,7 @@ TEST_CASE("Should parse all fields in the DSMR message correctly") {
   // Check that all fields have correct values
   REQUIRE(data.identification == "KFM5KAIFA-METER");
   REQUIRE(data.p1_version == "40");
-  REQUIRE(data.timestamp == "150117185916W");
+  REQUIRE(timestamp_text(data.timestamp) == "150117185916W");
   REQUIRE(data.equipment_id == "0000000000000000000000000000000000");
   REQUIRE(data.energy_delivered_tariff1 == 671.578f);
   REQUIRE(data.energy_delivered_tariff2 == 842.472f);
@@ -203,7 +206,7 @@ TEST_CASE("Should parse TimestampedFixedField for gas_delivered_be and expose ti
   const auto& res = P1Parser::parse(&data, msg, std::size(msg), /*unknown_error=*/false, /*check_crc=*/false);
   REQUIRE(res.err == nullptr);
   REQUIRE(data.gas_delivered_be == 12.345f);
-  REQUIRE(data.gas_delivered_be.timestamp == "230101120000W");
+  REQUIRE(timestamp_text(data.gas_delivered_be.timestamp) == "230101120000W");
 }
 
 TEST_CASE("Should take the last value with LastFixedField (capacity rate history)") {
@@ -387,6 +390,15 @@ TEST_CASE("Should report last dataline not CRLF terminated") {
   REQUIRE(std::string(res.err) == "Last dataline not CRLF terminated");
 }
 
+TEST_CASE("Should report a telegram without a line break as not CRLF terminated") {
+  const auto& msg = "/abc)!";
+
+  ParsedData<identification> data;
+  const auto& res = P1Parser::parse(&data, msg, std::size(msg) - 1, /*unknown_error=*/false, /*check_crc=*/false);
+  REQUIRE(std::string(res.err) == "Last dataline not CRLF terminated");
+  REQUIRE(res.ctx == msg + 5);
+}
+
 TEST_CASE("Should report an error if checksum is not found") {
   const auto& msg = "/AAA5MTR\r\n"
                     "\r\n"
@@ -656,3 +668,217 @@ TEST_CASE("AveragedFixedField works properly for an empty array") {
   REQUIRE(data.active_energy_import_maximum_demand_last_13_months.val() == 0.0f);
   REQUIRE(data.energy_delivered_tariff1.val() == 1.0f);
 }
+
+namespace custom_fields {
+DEFINE_FIELD(power_delivered_copy, FixedValue, ObisId(1, 0, 1, 7, 0), FixedField, units::kW, units::W);
+}
+
+TEST_CASE("If several fields have the same OBIS id, the first one is used") {
+  const auto& msg = "/AAA5MTR\r\n"
+                    "\r\n"
+                    "1-0:1.7.0(00.123*kW)\r\n"
+                    "!";
+
+  ParsedData<identification, custom_fields::power_delivered_copy, power_delivered> data;
+  const auto& res = P1Parser::parse(&data, msg, std::size(msg), /*unknown_error=*/false, /*check_crc=*/false);
+  REQUIRE(res.err == nullptr);
+  REQUIRE(data.power_delivered_copy == 0.123f);
+  REQUIRE_FALSE(data.power_delivered_present);
+}
+
+namespace custom_fields {
+DEFINE_FIELD(fixed_identification, FixedString<20>, ObisId(255, 255, 255, 255, 255, 255), RawField);
+DEFINE_FIELD(fixed_timestamp, FixedString<13>, ObisId(0, 0, 1, 0, 0), TimestampField);
+DEFINE_FIELD(fixed_equipment_id, FixedString<96>, ObisId(0, 0, 96, 1, 1), StringField, 0, 96);
+DEFINE_FIELD(fixed_gas_delivered, BasicTimestampedFixedValue<FixedString<13>>, ObisId(0, 1, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+}
+
+TEST_CASE("String values can be stored in a FixedString") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-0:1.0.0(150117185916W)\r\n"
+                    "0-0:96.1.1(4530303034303031353934373534343134)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "!";
+
+  ParsedData<custom_fields::fixed_identification, custom_fields::fixed_timestamp, custom_fields::fixed_equipment_id, custom_fields::fixed_gas_delivered> data;
+  const auto& res = P1Parser::parse(&data, msg, std::size(msg), /*unknown_error=*/true, /*check_crc=*/false);
+  REQUIRE(res.err == nullptr);
+  REQUIRE(data.fixed_identification == "KFM5KAIFA-METER");
+  REQUIRE(data.fixed_timestamp == "150117185916W");
+  REQUIRE(std::string(data.fixed_timestamp.c_str()) == "150117185916W");
+  REQUIRE(data.fixed_equipment_id == "4530303034303031353934373534343134");
+  REQUIRE(data.fixed_gas_delivered.timestamp == "150117180000W");
+  REQUIRE(data.fixed_gas_delivered == 473.789f);
+}
+
+TEST_CASE("RawField reports an error if the value doesn't fit into a FixedString") {
+  const auto& msg = "/KFM5KAIFA-METER-WITH-A-VERY-LONG-NAME\r\n"
+                    "\r\n"
+                    "!";
+
+  ParsedData<custom_fields::fixed_identification> data;
+  const auto& res = P1Parser::parse(&data, msg, std::size(msg), /*unknown_error=*/false, /*check_crc=*/false);
+  REQUIRE(std::string(res.err) == "Invalid string length");
+}
+
+TEST_CASE("FixedString can be assigned from C strings and empty views and written to a stream") {
+  FixedString<8> str;
+  str = "KFM5";
+  str.append(std::string_view().data(), 0);
+  REQUIRE(str == "KFM5");
+  str.assign(std::string_view().data(), 0);
+  REQUIRE(std::string(str.c_str()) == "");
+
+  std::ostringstream out;
+  str = "KFM5KAIFA-METER";
+  out << str;
+  REQUIRE(out.str() == "KFM5KAIF");
+}
+
+namespace custom_fields {
+DEFINE_FIELD(identification_view, std::string_view, ObisId(255, 255, 255, 255, 255, 255), RawField);
+DEFINE_FIELD(equipment_id_view, std::string_view, ObisId(0, 0, 96, 1, 1), StringField, 0, 96);
+DEFINE_FIELD(message_long_view, std::string_view, ObisId(0, 0, 96, 13, 0), StringField, 0, 2048);
+DEFINE_FIELD(gas_delivered_view, BasicTimestampedFixedValue<std::string_view>, ObisId(0, 1, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+}
+
+static_assert(has_string_view_fields<ParsedData<custom_fields::fixed_identification, custom_fields::gas_delivered_view>>::value);
+static_assert(!has_string_view_fields<ParsedData<custom_fields::fixed_identification, custom_fields::fixed_gas_delivered>>::value);
+
+TEST_CASE("String values can point into the parsed data") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-0:96.1.1(4530303034303031353934373534343134)\r\n"
+                    "0-0:96.13.0(3031323334\r\n"
+                    "3536373839)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "!";
+  const auto& msg_view = std::string_view(msg, std::size(msg));
+
+  ParsedData<custom_fields::identification_view, custom_fields::equipment_id_view, custom_fields::message_long_view, custom_fields::gas_delivered_view> data;
+  const auto& res = P1Parser::parse(&data, msg, std::size(msg), /*unknown_error=*/true, /*check_crc=*/false);
+  REQUIRE(res.err == nullptr);
+  REQUIRE(data.identification_view == "KFM5KAIFA-METER");
+  REQUIRE(data.equipment_id_view == "4530303034303031353934373534343134");
+  REQUIRE(data.message_long_view == "3031323334\r\n3536373839");
+  REQUIRE(data.gas_delivered_view.timestamp == "150117180000W");
+  REQUIRE(data.gas_delivered_view == 473.789f);
+
+  // Nothing is copied
+  REQUIRE(data.identification_view.data() == msg + 1);
+  REQUIRE(data.equipment_id_view.data() == msg + msg_view.find("453030"));
+  REQUIRE(data.gas_delivered_view.timestamp.data() == msg + msg_view.find("150117180000W"));
+}
+
+TEST_CASE("parse_selected gives the same fields as parse") {
+  const auto& msg = "/KMP5 ZABF000000000000\r\n"
+                    "\r\n"
+                    "1-3:0.2.8(50)\r\n"
+                    "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                    "(00124.477)\r\n"
+                    "0-0:96.13.0(303132333435363738393A3B3C3D3E3F\r\n"
+                    "303132333435363738393A3B3C3D3E3F)\r\n"
+                    "1-0:1.8.10(000002.000*kWh)\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "1-0:1.7.0(00.333*kW)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "!";
+
+  ParsedData<identification, p1_version, gas_delivered_text, message_long, energy_delivered_tariff1, power_delivered, gas_delivered> expected;
+  REQUIRE(P1Parser::parse(&expected, msg, std::size(msg), /*unknown_error=*/false, /*check_crc=*/false).err == nullptr);
+
+  ParsedData<identification, p1_version, gas_delivered_text, message_long, energy_delivered_tariff1, power_delivered, gas_delivered> data;
+  REQUIRE(P1Parser::parse_selected(&data, msg, std::size(msg), /*check_crc=*/false).err == nullptr);
+  REQUIRE(data.identification == expected.identification);
+  REQUIRE(data.p1_version == expected.p1_version);
+  REQUIRE(data.gas_delivered_text == expected.gas_delivered_text);
+  REQUIRE(data.message_long == expected.message_long);
+  REQUIRE(data.energy_delivered_tariff1 == 671.578f);
+  REQUIRE(data.power_delivered == 0.333f);
+  REQUIRE(data.gas_delivered == 473.789f);
+
+  // Only the lines of the selected fields are parsed, the other lines are skipped
+  ParsedData<power_delivered> power;
+  REQUIRE(P1Parser::parse_selected(&power, msg, std::size(msg), /*check_crc=*/false).err == nullptr);
+  REQUIRE(power.power_delivered == 0.333f);
+}
+
+TEST_CASE("parse_selected skips the continuation lines of the other fields") {
+  // The second line of the message looks like an energy_delivered_tariff1 line
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-0:96.13.0(303132\r\n"
+                    "1-0:1.8.1)\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "!";
+
+  ParsedData<energy_delivered_tariff1> expected;
+  REQUIRE(P1Parser::parse(&expected, msg, std::size(msg), /*unknown_error=*/false, /*check_crc=*/false).err == nullptr);
+
+  ParsedData<energy_delivered_tariff1> data;
+  REQUIRE(P1Parser::parse_selected(&data, msg, std::size(msg), /*check_crc=*/false).err == nullptr);
+  REQUIRE(data.energy_delivered_tariff1 == expected.energy_delivered_tariff1);
+  REQUIRE(data.energy_delivered_tariff1 == 671.578f);
+}
+
+TEST_CASE("parse_selected checks the CRC of the whole telegram") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "1-0:1.7.0(00.333*kW)\r\n"
+                    "1-0:1.8.1(000671.578*kWh)\r\n"
+                    "!1E1D";
+
+  ParsedData<power_delivered> data;
+  const auto& res = P1Parser::parse_selected(&data, msg, std::size(msg));
+  REQUIRE(std::string(res.err) == "Checksum mismatch");
+}
+
+TEST_CASE("parse_selected stops when all fields are present") {
+  const auto& msg = "/AAA5MTR\r\n"
+                    "\r\n"
+                    "1-0:1.7.0(00.123*kW)\r\n"
+                    "1-0:1.7.0(00.456*kW)\r\n"
+                    "1-0:1.8.1(garbage)\r\n"
+                    "!";
+
+  ParsedData<power_delivered> data;
+  const auto& res = P1Parser::parse_selected(&data, msg, std::size(msg), /*check_crc=*/false);
+  REQUIRE(res.err == nullptr);
+  REQUIRE(data.power_delivered == 0.123f);
+
+  ParsedData<power_delivered, energy_delivered_tariff1> both;
+  REQUIRE(std::string(P1Parser::parse_selected(&both, msg, std::size(msg), /*check_crc=*/false).err) == "Duplicate field");
+}
+
+TEST_CASE("parse_selected reports the errors of the selected lines") {
+  const auto& not_terminated = "/AAA5MTR\r\n"
+                               "\r\n"
+                               "1-0:1.8.1(000671.578*kWh)\r\n"
+                               "1-0:1.7.0(00.123*kW)!";
+  ParsedData<power_delivered> data;
+  REQUIRE(std::string(P1Parser::parse_selected(&data, not_terminated, std::size(not_terminated), /*check_crc=*/false).err) ==
+          "Last dataline not CRLF terminated");
+
+  const auto& trailing = "/AAA5MTR\r\n"
+                         "\r\n"
+                         "1-0:1.7.0(00.123*kW)x\r\n"
+                         "!";
+  ParsedData<power_delivered> data2;
+  REQUIRE(std::string(P1Parser::parse_selected(&data2, trailing, std::size(trailing), /*check_crc=*/false).err) == "Trailing characters on data line");
+}
+
+TEST_CASE("find_field compares the whole id") {
+  using Data = ParsedData<identification, energy_delivered_tariff1, power_delivered>;
+  const auto find = [](std::string_view line) { return Data::find_field(line.data(), line.data() + line.size()); };
+
+  const std::string_view line = "1-0:1.8.1(000671.578*kWh)";
+  REQUIRE(find(line).parse != nullptr);
+  REQUIRE(find(line).value == line.data() + line.find('('));
+  REQUIRE(find("1-0:1.7.0(00.333*kW)").parse != nullptr);
+  REQUIRE(find("1-0:1.8.10(000671.578*kWh)").parse == nullptr);
+  REQUIRE(find("1-0:1.8.(000671.578*kWh)").parse == nullptr);
+  REQUIRE(find("01-0:1.8.1(000671.578*kWh)").parse == nullptr);
+  REQUIRE(find("(00124.477)").parse == nullptr);
+  REQUIRE(find("").parse == nullptr);
+}
@@ -0,0 +1,6 @@
+// This code tests that the spsc_ring header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/spsc_ring.h"
+
+void SpscRing_some_function() { arduino_dsmr_2::SpscRing<char, 16> ring; }
@@ -0,0 +1,91 @@
+#include "arduino-dsmr-2/spsc_ring.h"
+#include <doctest.h>
+#include <thread>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+
+TEST_CASE("SpscRing keeps the order and the capacity") {
+  SpscRing<int, 4> ring;
+  REQUIRE(ring.empty());
+  REQUIRE(!ring.pop());
+
+  // The indexes pass the end of the storage several times
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(ring.push(round * 10 + i));
+    REQUIRE(!ring.push(100));
+    REQUIRE(ring.size() == 4);
+
+    for (int i = 0; i < 3; ++i)
+      REQUIRE(ring.pop() == round * 10 + i);
+    REQUIRE(ring.push(round * 10 + 4));
+    REQUIRE(ring.pop() == round * 10 + 3);
+    REQUIRE(ring.pop() == round * 10 + 4);
+    REQUIRE(ring.empty());
+  }
+}
+
+TEST_CASE("SpscRing pushes and pops in batches") {
+  SpscRing<int, 8> ring;
+  const std::vector<int> items = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  REQUIRE(ring.push(items) == 8);
+  REQUIRE(ring.push(items) == 0);
+
+  std::vector<int> popped(5);
+  REQUIRE(ring.pop(popped) == 5);
+  REQUIRE(popped == std::vector<int>{1, 2, 3, 4, 5});
+
+  REQUIRE(ring.push(std::span(items).subspan(8)) == 2);
+  popped.resize(10);
+  REQUIRE(ring.pop(popped) == 5);
+  REQUIRE(std::vector(popped.begin(), popped.begin() + 5) == std::vector<int>{6, 7, 8, 9, 10});
+  REQUIRE(ring.pop(popped) == 0);
+}
+
+TEST_CASE("SpscRing passes items between two threads") {
+  constexpr uint32_t number_of_items = 200000;
+  SpscRing<uint32_t, 64> ring;
+
+  // The producer alternates between single items and batches of different sizes
+  std::thread producer([&] {
+    std::vector<uint32_t> batch;
+    for (uint32_t next = 0; next < number_of_items;) {
+      if (next % 3 == 0) {
+        if (ring.push(next))
+          ++next;
+        else
+          std::this_thread::yield();
+        continue;
+      }
+      batch.clear();
+      for (uint32_t i = next; i < std::min(next + next % 50 + 1, number_of_items); ++i)
+        batch.push_back(i);
+      const auto pushed = static_cast<uint32_t>(ring.push(batch));
+      if (pushed == 0)
+        std::this_thread::yield();
+      next += pushed;
+    }
+  });
+
+  std::vector<uint32_t> received;
+  std::vector<uint32_t> batch(37);
+  while (received.size() < number_of_items) {
+    if (received.size() % 2 == 0) {
+      if (const auto item = ring.pop())
+        received.push_back(*item);
+      else
+        std::this_thread::yield();
+    } else {
+      const auto popped = ring.pop(batch);
+      if (popped == 0)
+        std::this_thread::yield();
+      received.insert(received.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(popped));
+    }
+  }
+  producer.join();
+
+  REQUIRE(ring.empty());
+  for (uint32_t i = 0; i < number_of_items; ++i)
+    REQUIRE(received[i] == i);
+}
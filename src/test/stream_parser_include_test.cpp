@@ -0,0 +1,13 @@
+// This code tests that the stream_parser header has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/stream_parser.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void StreamParser_some_function() {
+  StreamParser<ParsedData<energy_delivered_tariff1, power_delivered>> parser(std::span<char>(), true);
+  parser.process_byte('/');
+}
@@ -0,0 +1,132 @@
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/stream_parser.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::with_crc;
+
+// StreamParser overwrites its line buffer with the next line, so it doesn't support std::string_view fields
+#if !DSMR_STRING_VIEW_FIELDS
+
+namespace {
+using Data = ParsedData<identification, p1_version, timestamp, energy_delivered_tariff1, energy_delivered_tariff2, electricity_failure_log, gas_delivered,
+                        gas_delivered_text, message_long>;
+
+const std::string telegram = with_crc("/KFM5KAIFA-METER\r\n"
+                                      "\r\n"
+                                      "1-3:0.2.8(40)\r\n"
+                                      "0-0:1.0.0(150117185916W)\r\n"
+                                      "1-0:1.8.1(000671.578*kWh)\r\n"
+                                      "1-0:1.8.2(000842.472*kWh)\r\n"
+                                      "1-0:99.97.0(1)(0-0:96.7.19)(000101000001W)(2147483647*s)\r\n"
+                                      "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                                      "0-1:24.3.0(120517020000)(08)(60)(1)(0-1:24.2.1)(m3)\r\n"
+                                      "(00124.477)\r\n"
+                                      "0-0:96.13.0(303132333435363738393A3B3C3D3E3F\r\n"
+                                      "303132333435363738393A3B3C3D3E3F)\r\n"
+                                      "!");
+
+void require_same_fields(Data actual, const Data& expected) {
+  REQUIRE(actual.identification == expected.identification);
+  REQUIRE(actual.p1_version == expected.p1_version);
+  REQUIRE(actual.timestamp == expected.timestamp);
+  REQUIRE(actual.energy_delivered_tariff1.int_val() == expected.energy_delivered_tariff1.int_val());
+  REQUIRE(actual.energy_delivered_tariff2.int_val() == expected.energy_delivered_tariff2.int_val());
+  REQUIRE(actual.electricity_failure_log == expected.electricity_failure_log);
+  REQUIRE(actual.gas_delivered.int_val() == expected.gas_delivered.int_val());
+  REQUIRE(actual.gas_delivered_text == expected.gas_delivered_text);
+  REQUIRE(actual.message_long == expected.message_long);
+  REQUIRE(actual.all_present());
+}
+
+struct Received {
+  std::vector<Data> telegrams;
+  std::vector<StreamParserError> errors;
+  std::vector<std::string> parse_errors;
+};
+
+Received process(const std::string& bytes, const std::size_t line_buffer_size, const std::size_t chunk_size, const bool check_crc = true) {
+  std::vector<char> line_buffer(line_buffer_size);
+  StreamParser<Data> parser(line_buffer, check_crc);
+  Received received;
+  for (std::size_t i = 0; i < bytes.size(); i += chunk_size) {
+    parser.process(std::string_view(bytes).substr(i, chunk_size), [&](const StreamParser<Data>::Result& res) {
+      if (res.telegram())
+        received.telegrams.push_back(*res.telegram());
+      if (res.error())
+        received.errors.push_back(*res.error());
+      if (res.parse_error())
+        received.parse_errors.push_back(res.parse_error());
+    });
+  }
+  return received;
+}
+}
+
+TEST_CASE("StreamParser gives the same result as P1Parser::parse") {
+  Data expected;
+  REQUIRE(!P1Parser::parse(&expected, telegram.data(), telegram.size()).err);
+
+  // The line buffer only has to fit the longest logical line, which is the message split across two physical lines
+  for (std::size_t chunk_size = 1; chunk_size <= telegram.size(); chunk_size += 7) {
+    const auto received = process("garbage" + telegram + telegram, 90, chunk_size);
+    REQUIRE(received.errors.empty());
+    REQUIRE(received.telegrams.size() == 2);
+    require_same_fields(received.telegrams[0], expected);
+    require_same_fields(received.telegrams[1], expected);
+  }
+
+  const auto without_crc = telegram.substr(0, telegram.find('!') + 1);
+  const auto received = process(without_crc, 90, 1, false);
+  REQUIRE(received.telegrams.size() == 1);
+  require_same_fields(received.telegrams[0], expected);
+}
+
+TEST_CASE("StreamParser reports the data of the telegram as soon as the CRC arrives") {
+  std::vector<char> line_buffer(90);
+  StreamParser<Data> parser(line_buffer, true);
+  const auto crc_end = telegram.find('!') + 5;
+
+  for (std::size_t i = 0; i + 1 < crc_end; ++i)
+    REQUIRE(!parser.process_byte(telegram[i]).telegram());
+  REQUIRE(parser.data().message_long_present);
+
+  const auto res = parser.process_byte(telegram[crc_end - 1]);
+  REQUIRE(res.telegram() == &parser.data());
+}
+
+TEST_CASE("StreamParser reports errors after the CRC check and recovers with the next telegram") {
+  auto corrupted = telegram;
+  corrupted[corrupted.find("1-3:0.2.8")] = 'X';
+  auto invalid_crc_symbol = telegram;
+  invalid_crc_symbol[invalid_crc_symbol.find('!') + 1] = 'G';
+  const auto unknown_unit = with_crc("/KFM5KAIFA-METER\r\n"
+                                     "\r\n"
+                                     "1-0:1.8.1(000671.578*kW)\r\n"
+                                     "!");
+  const auto not_terminated = with_crc("/KFM5KAIFA-METER\r\n"
+                                       "\r\n"
+                                       "1-0:1.8.1(000671.578*kWh)!");
+  const auto no_line_break = with_crc("/abc)!");
+
+  const auto received =
+      process(corrupted + telegram.substr(0, 50) + invalid_crc_symbol + unknown_unit + not_terminated + no_line_break + telegram, 90, 13);
+  REQUIRE(received.errors == std::vector{StreamParserError::CrcMismatch, StreamParserError::PacketStartSymbolInPacket, StreamParserError::IncorrectCrcCharacter,
+                                         StreamParserError::ParseError, StreamParserError::ParseError, StreamParserError::ParseError});
+  REQUIRE(received.parse_errors ==
+          std::vector<std::string>{"Invalid unit", "Last dataline not CRLF terminated", "Last dataline not CRLF terminated"});
+  REQUIRE(received.telegrams.size() == 1);
+  REQUIRE(received.telegrams[0].energy_delivered_tariff1.int_val() == 671578);
+}
+
+TEST_CASE("StreamParser reports lines that don't fit into the line buffer") {
+  const auto received = process(telegram + telegram, 60, 1);
+  REQUIRE(received.errors == std::vector{StreamParserError::LineTooLong, StreamParserError::LineTooLong});
+  REQUIRE(received.telegrams.empty());
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "arduino-dsmr-2/crc16.h"
+#include "arduino-dsmr-2/util.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Telegrams that the tests build at runtime
+namespace test_helpers {
+
+// Appends the CRC and the line break that follow the '!' of a telegram
+inline std::string with_crc(const std::string& data) {
+  char crc[5];
+  std::snprintf(crc, sizeof(crc), "%04X", arduino_dsmr_2::Crc16::update(0, data.data(), data.size()));
+  return data + crc + "\r\n";
+}
+
+// A short telegram with a valid CRC whose energy_delivered_tariff1 is `energy` Wh, so every telegram of a test can be told apart
+inline std::string telegram(const uint32_t energy) {
+  char value[16];
+  std::snprintf(value, sizeof(value), "%06u.%03u", energy / 1000, energy % 1000);
+  return with_crc(std::string("/KFM5KAIFA-METER\r\n"
+                              "\r\n"
+                              "1-0:1.8.1(") +
+                  value + "*kWh)\r\n!");
+}
+
+// The YYMMDDhhmmssX text of a timestamp field, whether it is stored as a string or as a Timestamp (DSMR_TYPED_TIMESTAMPS)
+inline std::string timestamp_text(const arduino_dsmr_2::Timestamp& timestamp) {
+  const auto text = timestamp.text();
+  return std::string(text.data(), text.size());
+}
+inline std::string timestamp_text(const std::string_view timestamp) { return std::string(timestamp); }
+
+}
@@ -0,0 +1,14 @@
+// This code tests that the time series has all necessary dependencies included in its headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/time_series.h"
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+void TimeSeries_some_function() {
+  TimeSeries<DefaultTimeSeriesCapacity, power_delivered> history;
+  ParsedData<identification, power_delivered> data;
+  history.add(0, data);
+  history.series<power_delivered>().quarter_hours().current().average();
+}
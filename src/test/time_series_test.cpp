@@ -0,0 +1,107 @@
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/time_series.h"
+#include <doctest.h>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+
+namespace {
+using Data = ParsedData<identification, power_delivered, power_returned, gas_delivered>;
+
+Data make_data(const uint32_t power) {
+  Data data;
+  data.power_delivered._value = power;
+  data.power_delivered_present = true;
+  return data;
+}
+}
+
+TEST_CASE("TimeSeriesBuckets aggregates the values of every period") {
+  TimeSeriesBuckets<4, 60> buckets;
+  REQUIRE(buckets.current().empty());
+
+  REQUIRE(buckets.add(120, 300));
+  REQUIRE(buckets.add(150, 100));
+  REQUIRE(buckets.add(179, 200));
+  REQUIRE(buckets.current().count == 3);
+  REQUIRE(buckets.current().min == 100);
+  REQUIRE(buckets.current().max == 300);
+  REQUIRE(buckets.current().average() == 200);
+  REQUIRE(buckets.start_time(0) == 120);
+
+  // The next period, and a period without values
+  REQUIRE(buckets.add(180, 50));
+  REQUIRE(buckets.add(300, 70));
+  REQUIRE(buckets.current().count == 1);
+  REQUIRE(buckets.bucket(1).empty());
+  REQUIRE(buckets.bucket(2).average() == 50);
+  REQUIRE(buckets.bucket(3).max == 300);
+  REQUIRE(buckets.start_time(3) == 120);
+
+  // The periods that don't fit into the buffer are empty, and the periods before time 0 start at 0
+  REQUIRE(buckets.bucket(4).empty());
+  REQUIRE(buckets.bucket(8).empty());
+  REQUIRE(buckets.start_time(5) == 0);
+  REQUIRE(buckets.start_time(100) == 0);
+
+  const auto last = buckets.last(4);
+  REQUIRE(last.count == 5);
+  REQUIRE(last.min == 50);
+  REQUIRE(last.max == 300);
+  REQUIRE(last.sum == 720);
+  REQUIRE(buckets.last(2).count == 1);
+
+  // The values before the current period are ignored
+  REQUIRE_FALSE(buckets.add(299, 1000));
+  REQUIRE(buckets.last(4).count == 5);
+}
+
+TEST_CASE("TimeSeriesBuckets forgets the periods that don't fit") {
+  TimeSeriesBuckets<3, 1> buckets;
+  for (uint32_t time = 0; time < 5; ++time)
+    REQUIRE(buckets.add(time, time));
+  REQUIRE(buckets.last(10).count == 3);
+  REQUIRE(buckets.last(10).min == 2);
+
+  // A gap longer than the buffer
+  REQUIRE(buckets.add(100, 7));
+  REQUIRE(buckets.last(3).count == 1);
+  REQUIRE(buckets.current().max == 7);
+
+  buckets.clear();
+  REQUIRE(buckets.last(3).empty());
+  REQUIRE(buckets.add(0, 1));
+}
+
+TEST_CASE("TimeSeries keeps the history of the fields at 3 resolutions") {
+  TimeSeries<TimeSeriesCapacity<10, 20, 4>, power_delivered, power_returned> history;
+
+  // One telegram every second, starting at the beginning of a quarter hour. The power goes from 0 W to 899 W.
+  const uint32_t start = 1'700'000'100;
+  REQUIRE(start % 900 == 0);
+  for (uint32_t i = 0; i < 900; ++i)
+    REQUIRE(history.add(start + i, make_data(i)));
+
+  const auto& power = history.series<power_delivered>();
+  REQUIRE(power.seconds().current().max == 899);
+  REQUIRE(power.seconds().last(10).average() == 894);
+  REQUIRE(power.minutes().current().min == 840);
+  REQUIRE(power.minutes().current().average() == 869);
+  REQUIRE(power.minutes().bucket(14).average() == 29);
+  REQUIRE(power.quarter_hours().current().count == 900);
+  REQUIRE(power.quarter_hours().current().average() == 449);
+  REQUIRE(power.quarter_hours().current().max == 899);
+  REQUIRE(power.quarter_hours().start_time(0) == start);
+
+  // power_returned wasn't in the telegrams
+  REQUIRE(history.series<power_returned>().quarter_hours().current().empty());
+
+  // The next quarter hour
+  REQUIRE(history.add(start + 900, make_data(5000)));
+  REQUIRE(power.quarter_hours().current().average() == 5000);
+  REQUIRE(power.quarter_hours().bucket(1).average() == 449);
+
+  REQUIRE_FALSE(history.add(start, make_data(1)));
+  history.clear();
+  REQUIRE(power.quarter_hours().current().empty());
+}
@@ -0,0 +1,108 @@
+#include "arduino-dsmr-2/binary_serializer.h"
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/json_writer.h"
+#include "test_helpers.h"
+#include <array>
+#include <doctest.h>
+#include <sstream>
+#include <string>
+
+using namespace arduino_dsmr_2;
+using test_helpers::timestamp_text;
+
+TEST_CASE("TimestampParser converts the text of a timestamp") {
+  const auto timestamp = TimestampParser::parse("150117185916W");
+  REQUIRE(timestamp.valid());
+  REQUIRE_FALSE(timestamp.summer_time);
+  REQUIRE(timestamp.unix_time() == 1421517556); // 2015-01-17 17:59:16 UTC
+  REQUIRE(timestamp_text(timestamp) == "150117185916W");
+
+  const auto summer = TimestampParser::parse("240630235959S");
+  REQUIRE(summer.summer_time);
+  REQUIRE(summer.unix_time() == 1719784799); // 2024-06-30 21:59:59 UTC
+  REQUIRE(timestamp_text(summer) == "240630235959S");
+
+  REQUIRE(TimestampParser::parse("000101000000W").seconds == 0);
+  REQUIRE(timestamp_text(TimestampParser::parse("000101000000W")) == "000101000000W");
+  REQUIRE(timestamp_text(TimestampParser::parse("240229120000W")) == "240229120000W");
+  REQUIRE(timestamp_text(TimestampParser::parse("991231235959W")) == "991231235959W");
+
+  std::ostringstream out;
+  out << summer;
+  REQUIRE(out.str() == "240630235959S");
+}
+
+TEST_CASE("TimestampParser rejects the texts that are not a date and time") {
+  for (const auto invalid : {"632525252525W", "150117185916X", "15011718591", "15a117185916W", "150230000000W", "230229000000W", "150117240000W",
+                             "150117186000W", "000101000000S"}) {
+    REQUIRE_FALSE(TimestampParser::parse(invalid).valid());
+  }
+  REQUIRE(timestamp_text(Timestamp::invalid()) == "000000000000W");
+
+  // The cache of the date doesn't keep an invalid date
+  REQUIRE_FALSE(TimestampParser::parse("150230000000W").valid());
+  REQUIRE_FALSE(TimestampParser::parse("150230000001W").valid());
+  REQUIRE(TimestampParser::parse("150228000000W").valid());
+}
+
+TEST_CASE("Timestamps are ordered and can be subtracted around the switch to winter time") {
+  // On 2023-10-29, 02:00-03:00 comes twice: first in summer time, then in winter time
+  const auto before = TimestampParser::parse("231029023000S");
+  const auto after = TimestampParser::parse("231029021500W");
+  REQUIRE(before < after);
+  REQUIRE(after - before == 45 * 60);
+  REQUIRE(before.local_seconds() > after.local_seconds());
+
+  // Timestamps with the date of the previous one use the cached date
+  REQUIRE(TimestampParser::parse("231029030000W") - after == 45 * 60);
+  REQUIRE(TimestampParser::parse("231028030000S") - before == -(24 * 3600 - 30 * 60));
+  REQUIRE(TimestampParser::parse("231029023000S") == before);
+}
+
+namespace typed_fields {
+using namespace arduino_dsmr_2::fields;
+DEFINE_FIELD(timestamp, Timestamp, ObisId(0, 0, 1, 0, 0), TimestampField);
+DEFINE_FIELD(gas_delivered, TypedTimestampedFixedValue, ObisId(0, GAS_MBUS_ID, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+DEFINE_FIELD(water_delivered, TypedTimestampedFixedValue, ObisId(0, WATER_MBUS_ID, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+}
+
+// The same fields with the timestamps as strings, also with DSMR_TYPED_TIMESTAMPS
+namespace string_fields {
+using namespace arduino_dsmr_2::fields;
+DEFINE_FIELD(timestamp, FixedString<13>, ObisId(0, 0, 1, 0, 0), TimestampField);
+DEFINE_FIELD(gas_delivered, BasicTimestampedFixedValue<FixedString<13>>, ObisId(0, GAS_MBUS_ID, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+DEFINE_FIELD(water_delivered, BasicTimestampedFixedValue<FixedString<13>>, ObisId(0, WATER_MBUS_ID, 24, 2, 1), TimestampedFixedField, units::m3, units::dm3);
+}
+
+TEST_CASE("Fields can store their timestamps as a Timestamp") {
+  const auto& msg = "/KFM5KAIFA-METER\r\n"
+                    "\r\n"
+                    "0-0:1.0.0(150117185916W)\r\n"
+                    "0-1:24.2.1(150117180000W)(00473.789*m3)\r\n"
+                    "0-2:24.2.1(632525252525W)(00000.000*m3)\r\n"
+                    "!";
+  ParsedData<typed_fields::timestamp, typed_fields::gas_delivered, typed_fields::water_delivered> data;
+  REQUIRE(P1Parser::parse(&data, msg, std::size(msg) - 1, /*unknown_error=*/true, /*check_crc=*/false).err == nullptr);
+  REQUIRE(data.timestamp == TimestampParser::parse("150117185916W"));
+  REQUIRE(data.timestamp - data.gas_delivered.timestamp == 59 * 60 + 16);
+  REQUIRE(data.gas_delivered.int_val() == 473789);
+  REQUIRE_FALSE(data.water_delivered.timestamp.valid());
+
+  std::array<char, 512> json;
+  const auto json_size = JsonWriter::write(data, json);
+  REQUIRE(std::string(json.data(), json_size) == "{\"timestamp\":\"150117185916W\",\"gas_delivered\":{\"value\":473.789,\"timestamp\":\"150117180000W\"},"
+                                                 "\"water_delivered\":{\"value\":0.000,\"timestamp\":null}}");
+
+  std::array<char, 512> record;
+  const auto record_size = BinarySerializer::encode(data, record);
+  decltype(data) decoded;
+  REQUIRE(BinarySerializer::decode(&decoded, std::span<const char>(record).first(record_size)).err == nullptr);
+  REQUIRE(decoded.timestamp == data.timestamp);
+  REQUIRE(decoded.gas_delivered.timestamp == data.gas_delivered.timestamp);
+  REQUIRE_FALSE(decoded.water_delivered.timestamp.valid());
+
+  // A record with the timestamps as strings can't be decoded into typed timestamps
+  ParsedData<string_fields::timestamp, string_fields::gas_delivered, string_fields::water_delivered> strings;
+  const auto strings_size = BinarySerializer::encode(strings, record);
+  REQUIRE(std::string(BinarySerializer::decode(&decoded, std::span<const char>(record).first(strings_size)).err) == "Schema mismatch");
+}
@@ -0,0 +1,12 @@
+// This code tests that the timing statistics have all necessary dependencies included in their headers.
+// We check that the code compiles.
+
+#include "arduino-dsmr-2/timing_stats.h"
+
+using namespace arduino_dsmr_2;
+
+void timing_stats_some_function() {
+  timing::count(&TimingStats::bytes_consumed);
+  [[maybe_unused]] const auto crc = timing::measure(&TimingStats::crc_time, [] { return 0; });
+  [[maybe_unused]] const uint64_t packets = timing_stats().packets_emitted;
+}
@@ -0,0 +1,181 @@
+#include "arduino-dsmr-2/encrypted_packet_accumulator.h"
+#include "arduino-dsmr-2/fields.h"
+#include "arduino-dsmr-2/packet_accumulator.h"
+#include "arduino-dsmr-2/parser.h"
+#include "arduino-dsmr-2/timing_stats.h"
+#include "test_helpers.h"
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace arduino_dsmr_2;
+using namespace fields;
+using test_helpers::with_crc;
+
+static_assert(DSMR_TIMING_STATS, "The tests are compiled with DSMR_TIMING_STATS=1");
+
+namespace {
+// The statistics are process-wide, so the tests check how much they changed
+struct Snapshot {
+  uint64_t bytes_consumed = timing_stats().bytes_consumed;
+  uint64_t packets_emitted = timing_stats().packets_emitted;
+  uint64_t buffer_overflows = timing_stats().packet_errors[static_cast<size_t>(PacketAccumulator::Error::BufferOverflow)];
+  uint64_t crc_mismatches = timing_stats().packet_errors[static_cast<size_t>(PacketAccumulator::Error::CrcMismatch)];
+  uint64_t crc_time = timing_stats().crc_time;
+  uint64_t encrypted_bytes_consumed = timing_stats().encrypted_bytes_consumed;
+  uint64_t encrypted_packets_emitted = timing_stats().encrypted_packets_emitted;
+  uint64_t header_corrupted = timing_stats().encrypted_packet_errors[static_cast<size_t>(EncryptedPacketAccumulator::Error::HeaderCorrupted)];
+  uint64_t decryption_failed = timing_stats().encrypted_packet_errors[static_cast<size_t>(EncryptedPacketAccumulator::Error::DecryptionFailed)];
+  uint64_t decrypt_time = timing_stats().decrypt_time;
+  uint64_t telegrams_parsed = timing_stats().telegrams_parsed;
+  uint64_t parse_time = timing_stats().parse_time;
+  uint64_t field_parse_time = timing_stats().field_parse_time;
+};
+
+const std::string telegram = "/KFM5KAIFA-METER\r\n"
+                             "\r\n"
+                             "1-3:0.2.8(40)\r\n"
+                             "1-0:1.8.1(000671.578*kWh)\r\n"
+                             "1-0:1.8.2(000842.472*kWh)\r\n"
+                             "!";
+
+std::vector<uint8_t> read_encrypted_packet() {
+  std::ifstream file(std::filesystem::path(std::source_location::current().file_name()).parent_path() / "test_data" / "encrypted_packet.bin", std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+}
+
+TEST_CASE("PacketAccumulator counts bytes, packets and errors") {
+  const auto packet = with_crc(telegram);
+  const auto corrupted_packet = with_crc(telegram).replace(2, 1, "X");
+  std::vector<char> buffer(1000);
+  PacketAccumulator accumulator(buffer, true);
+
+  auto check = [&](auto&& feed) {
+    const Snapshot before;
+    feed(packet + corrupted_packet);
+
+    const Snapshot after;
+    REQUIRE(after.bytes_consumed - before.bytes_consumed == packet.size() + corrupted_packet.size());
+    REQUIRE(after.packets_emitted - before.packets_emitted == 1);
+    REQUIRE(after.crc_mismatches - before.crc_mismatches == 1);
+    REQUIRE(after.buffer_overflows == before.buffer_overflows);
+  };
+
+  check([&](const std::string& bytes) {
+    for (const auto& byte : bytes)
+      accumulator.process_byte(byte);
+  });
+  check([&](const std::string& bytes) { accumulator.process(bytes, [](const auto&) {}); });
+}
+
+TEST_CASE("PacketAccumulator counts buffer overflows") {
+  std::vector<char> buffer(10);
+  PacketAccumulator accumulator(buffer, false);
+  const Snapshot before;
+
+  for (const auto& byte : std::string_view("/packet that doesn't fit!"))
+    accumulator.process_byte(byte);
+
+  REQUIRE(Snapshot().buffer_overflows - before.buffer_overflows == 1);
+}
+
+TEST_CASE("EncryptedPacketAccumulator counts bytes, packets and errors") {
+  const auto packet = read_encrypted_packet();
+  auto corrupted_packet = packet;
+  corrupted_packet.back() ^= 1;
+  auto corrupted_header = std::vector<uint8_t>(packet.begin(), packet.begin() + 18);
+  corrupted_header[1] = 0;
+
+  auto check = [&](EncryptedPacketAccumulator& accumulator) {
+    REQUIRE(!accumulator.set_encryption_key("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"));
+    const Snapshot before;
+
+    for (const auto& bytes : {packet, corrupted_packet, corrupted_header}) {
+      for (const auto& byte : bytes)
+        accumulator.process_byte(byte);
+      accumulator.reset();
+    }
+
+    const Snapshot after;
+    REQUIRE(after.encrypted_bytes_consumed - before.encrypted_bytes_consumed == packet.size() * 2 + corrupted_header.size());
+    REQUIRE(after.encrypted_packets_emitted - before.encrypted_packets_emitted == 1);
+    REQUIRE(after.decryption_failed - before.decryption_failed == 1);
+    REQUIRE(after.header_corrupted - before.header_corrupted == 1);
+    REQUIRE(after.decrypt_time > before.decrypt_time);
+    REQUIRE(after.bytes_consumed == before.bytes_consumed);
+  };
+
+  SUBCASE("Separate buffers") {
+    std::vector<uint8_t> encrypted_packet_buffer(2000);
+    std::vector<char> decrypted_packet_buffer(2000);
+    EncryptedPacketAccumulator accumulator(encrypted_packet_buffer, decrypted_packet_buffer);
+    check(accumulator);
+  }
+
+  SUBCASE("Single buffer") {
+    std::vector<char> buffer(2000);
+    EncryptedPacketAccumulator accumulator(buffer);
+    check(accumulator);
+  }
+}
+
+TEST_CASE("P1Parser measures telegrams and fields") {
+  const auto packet = with_crc(telegram);
+  const Snapshot before;
+  const auto tariff1_before = field_timing_stats<energy_delivered_tariff1>().parses.load();
+  const auto tariff2_before = field_timing_stats<energy_delivered_tariff2>().parses.load();
+
+  ParsedData<p1_version, energy_delivered_tariff1> data;
+  REQUIRE(!P1Parser::parse(&data, packet.data(), packet.size()).err);
+
+  const Snapshot after;
+  REQUIRE(after.telegrams_parsed - before.telegrams_parsed == 1);
+  REQUIRE(after.parse_time > before.parse_time);
+  // The CRC and the fields can take less time than the resolution of the clock
+  REQUIRE(after.parse_time - before.parse_time >= after.crc_time - before.crc_time);
+  REQUIRE(after.parse_time - before.parse_time >= after.field_parse_time - before.field_parse_time);
+  REQUIRE(timing_stats().slowest_telegram_time >= after.parse_time - before.parse_time);
+
+  REQUIRE(field_timing_stats<energy_delivered_tariff1>().parses == tariff1_before + 1);
+  REQUIRE(field_timing_stats<energy_delivered_tariff2>().parses == tariff2_before);
+
+  const auto timings = decltype(data)::field_timings();
+  REQUIRE(std::string_view(timings[0].name) == "p1_version");
+  REQUIRE(timings[0].stats == &field_timing_stats<p1_version>());
+  REQUIRE(std::string_view(timings[1].name) == "energy_delivered_tariff1");
+  REQUIRE(timings[1].stats->parses == tariff1_before + 1);
+}
+
+TEST_CASE("Statistics can be read while another thread updates them") {
+  const auto packet = with_crc(telegram);
+  const Snapshot before;
+  constexpr uint64_t number_of_packets = 200;
+
+  std::thread writer([&] {
+    std::vector<char> buffer(1000);
+    PacketAccumulator accumulator(buffer, true);
+    for (uint64_t i = 0; i < number_of_packets; ++i) {
+      accumulator.process(packet, [](const auto& res) {
+        ParsedData<energy_delivered_tariff1> data;
+        P1Parser::parse(&data, res.packet()->data(), res.packet()->size(), false, false);
+      });
+    }
+  });
+
+  uint64_t previous = before.telegrams_parsed;
+  while (previous - before.telegrams_parsed < number_of_packets) {
+    const uint64_t current = timing_stats().telegrams_parsed;
+    REQUIRE(current >= previous);
+    previous = current;
+  }
+  writer.join();
+
+  const Snapshot after;
+  REQUIRE(after.packets_emitted - before.packets_emitted == number_of_packets);
+  REQUIRE(after.bytes_consumed - before.bytes_consumed == number_of_packets * packet.size());
+}